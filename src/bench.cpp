@@ -0,0 +1,1183 @@
+// bench.cpp
+// Standalone benchmarks for the engine core. Usage:
+//   viperchess-bench alloc [depth]   heap allocations per searched node
+//   viperchess-bench perft [depth]   make-and-test vs pin/check-mask legality
+//   viperchess-bench sliders [M]     slider attack lookups per second (M million)
+//   viperchess-bench tt [MB]         transposition table allocation time, random probes per second
+//   viperchess-bench search [depth]  fixed-depth search over the bench positions, NPS, first-move cutoff rate
+//   viperchess-bench smp [depth] [max threads]  Lazy SMP time-to-depth for 1, 2, 4, ... threads
+//   viperchess-bench pool [threads] [searches]   per-go overhead, thread pool vs fresh threads
+//   viperchess-bench stop [threads] [rounds]     stop-to-bestmove, movetime and ponderhit latency
+//   viperchess-bench nodes [N]       `go nodes N` searches repeated: reproducible results, NPS
+//   viperchess-bench clock [games]   self-play on simulated clocks: flags, time used against the budget
+//   viperchess-bench draw [games]    repetition, fifty-move and upcoming-repetition detection vs brute force
+//   viperchess-bench prune [depth]   nodes-to-depth and branching factor with LMR/futility/SEE on and off
+//   viperchess-bench see             static exchange evaluation on hand-checked exchanges
+//   viperchess-bench picker [depth]  MovePicker and is_pseudo_legal checked against the generator
+//   viperchess-bench book            UCI position and OwnBook against a two-move test book
+//   viperchess-bench encodings       Polyglot and Fathom move encodings against the formats' specifications
+//   viperchess-bench keys [depth]    Polyglot reference keys, incremental vs full hashing
+#include "board.hpp"
+#include "eval.hpp"
+#include "movegen.hpp"
+#include "movepick.hpp"
+#include "search.hpp"
+#include "thread.hpp"
+#include "uci.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===== Allocation Counting =====
+// Replacing the global allocation functions in this binary also covers every
+// allocation made inside the engine core, so the counter sees all heap traffic.
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+}
+
+// All of them stay out of line. Inlined into a caller, malloc() would meet
+// operator delete or free() a pointer from operator new, and GCC's
+// -Wmismatched-new-delete cannot see that they are replaced as a set.
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void* operator new(std::size_t size, std::align_val_t align) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t a = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+// Both kinds of operator new allocate with the C allocator, so every delete
+// frees with it
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace ViperChess {
+namespace {
+
+// Mix of opening, middlegame and endgame positions (mostly perft suite)
+const char* BENCH_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+// Searches every bench position to a fixed depth and reports how many heap
+// allocations happened while the search was running. Setup (board, TT) is
+// excluded. Returns non-zero if any search allocated.
+int bench_alloc(int depth) {
+    Evaluator evaluator;
+    Searcher searcher(evaluator);
+    Board board;
+
+    SearchParams params;
+    params.depth = depth;
+    params.use_time = false;
+
+    uint64_t total_nodes = 0;
+    uint64_t total_allocs = 0;
+
+    for (const char* fen : BENCH_FENS) {
+        board.set_fen(fen);
+
+        uint64_t before = g_allocations.load();
+        SearchResult result = searcher.search(board, params);
+        uint64_t allocs = g_allocations.load() - before;
+
+        total_nodes += result.nodes;
+        total_allocs += allocs;
+        std::cout << "nodes " << result.nodes << " allocations " << allocs
+                  << "  " << fen << "\n";
+    }
+
+    std::cout << "total nodes " << total_nodes
+              << " allocations " << total_allocs
+              << " per node " << (total_nodes ? double(total_allocs) / total_nodes : 0.0)
+              << "\n";
+    return total_allocs == 0 ? 0 : 1;
+}
+
+// Fixed-depth search of every bench position; the total node count doubles
+// as a signature of the search, the NPS as its speed.
+int bench_search(int depth) {
+    Evaluator evaluator;
+    Searcher searcher(evaluator);
+    Board board;
+
+    SearchParams params;
+    params.depth = depth;
+    params.use_time = false;
+
+    uint64_t total_nodes = 0;
+    uint64_t cutoffs = 0;
+    uint64_t first_move_cutoffs = 0;
+    double seconds = 0;
+
+    for (const char* fen : BENCH_FENS) {
+        board.set_fen(fen);
+
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result = searcher.search(board, params);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        total_nodes += result.nodes;
+        cutoffs += result.cutoffs;
+        first_move_cutoffs += result.first_move_cutoffs;
+        std::cout << "nodes " << result.nodes << "  " << fen << "\n";
+    }
+
+    // The share of cutoffs made by the first move tried: the higher, the
+    // better the move ordering
+    std::cout << "total nodes " << total_nodes
+              << " time " << int(seconds * 1000) << " ms"
+              << " nps " << uint64_t(total_nodes / seconds)
+              << " first-move cutoffs " << std::fixed << std::setprecision(1)
+              << 100.0 * first_move_cutoffs / std::max<uint64_t>(1, cutoffs) << "%\n";
+    return 0;
+}
+
+// Nodes needed to complete each depth over the bench positions, with late
+// move reductions, futility pruning and SEE pruning each on and off. The effective
+// branching factor at depth d is nodes-to-d / nodes-to-(d-1), summed over
+// the positions; the TT is cleared before every search.
+int bench_prune(int depth) {
+    Evaluator evaluator;
+    Searcher searcher(evaluator);
+    Board board;
+
+    struct Config {
+        const char* name;
+        bool lmr;
+        bool futility;
+        bool see;
+    };
+    const Config configs[] = {
+        {"none", false, false, false},
+        {"futility", false, true, false},
+        {"lmr", true, false, false},
+        {"see", false, false, true},
+        {"lmr+futility", true, true, false},
+        {"lmr+futility+see", true, true, true},
+    };
+
+    for (const Config& config : configs) {
+        std::vector<uint64_t> nodes_to(depth + 1, 0);
+        SearchParams params;
+        params.depth = depth;
+        params.use_time = false;
+        params.lmr = config.lmr;
+        params.futility = config.futility;
+        params.see_pruning = config.see;
+        params.on_iteration = [&nodes_to](const SearchResult& result) {
+            nodes_to[result.depth] += result.nodes;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        for (const char* fen : BENCH_FENS) {
+            board.set_fen(fen);
+            TT.clear();
+            searcher.search(board, params);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << config.name << ": time " << int(seconds * 1000) << " ms\n"
+                  << "  depth      nodes    EBF\n";
+        for (int d = 1; d <= depth; ++d) {
+            std::cout << "  " << std::setw(5) << d << std::setw(11) << nodes_to[d];
+            if (d > 1 && nodes_to[d - 1]) {
+                std::cout << std::setw(7) << std::fixed << std::setprecision(2)
+                          << double(nodes_to[d]) / nodes_to[d - 1] << std::defaultfloat;
+            }
+            std::cout << "\n";
+        }
+    }
+    return 0;
+}
+
+// Time to reach a fixed depth on every bench position with 1, 2, 4, ...
+// threads sharing the transposition table. The table is cleared before each
+// search so no run profits from the one before it.
+int bench_smp(int depth, int max_threads) {
+    Evaluator evaluator;
+    ThreadPool pool(evaluator);
+    Board board;
+
+    SearchParams params;
+    params.depth = depth;
+    params.use_time = false;
+
+    double base_seconds = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        pool.set(threads);
+        uint64_t total_nodes = 0;
+        double seconds = 0;
+
+        for (const char* fen : BENCH_FENS) {
+            board.set_fen(fen);
+            TT.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            pool.start_search(board, params);
+            pool.wait_for_search_finished();
+            const SearchResult& result = pool.result();
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            total_nodes += result.nodes;
+        }
+
+        if (threads == 1) base_seconds = seconds;
+        std::cout << "threads " << threads
+                  << " time " << int(seconds * 1000) << " ms"
+                  << " nodes " << total_nodes
+                  << " nps " << uint64_t(total_nodes / seconds)
+                  << " speedup " << base_seconds / seconds << "x\n";
+    }
+    return 0;
+}
+
+// Runs many depth-1 searches, so the cost is almost all thread start-up:
+// once through the persistent pool, once creating a Searcher and a thread
+// per search thread for every go, as handle_go and parallel_search used to.
+int bench_pool(int threads, int searches) {
+    Evaluator evaluator;
+    Board board;
+
+    SearchParams params;
+    params.depth = 1;
+    params.use_time = false;
+
+    ThreadPool pool(evaluator);
+    pool.set(threads);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < searches; ++i) {
+        pool.start_search(board, params);
+        pool.wait_for_search_finished();
+    }
+    double pool_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < searches; ++i) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&evaluator, &board, &params]() {
+                Searcher searcher(evaluator);
+                searcher.search(board, params);
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+    double spawn_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "threads " << threads << " searches " << searches << "\n"
+              << "pool:  " << pool_seconds * 1e6 / searches << " us per go\n"
+              << "spawn: " << spawn_seconds * 1e6 / searches << " us per go\n";
+    return 0;
+}
+
+// Time from a signal to the end of the search, i.e. to the bestmove callback,
+// over every bench position at several points into the search:
+//  - stop:      `go infinite`, then `stop`
+//  - movetime:  `go movetime 50`, overshoot past the 50 ms
+//  - ponderhit: `go ponder movetime 50`, then `ponderhit`; overshoot past
+//               the 50 ms that start at ponderhit
+// Returns non-zero if any stop took 5 ms or more.
+int bench_stop(int threads, int rounds) {
+    using Clock = std::chrono::steady_clock;
+    const int MOVETIME = 50;
+
+    Evaluator evaluator;
+    ThreadPool pool(evaluator);
+    pool.set(threads);
+    Board board;
+
+    Clock::time_point done;
+    auto on_done = [&done](const SearchResult&) { done = Clock::now(); };
+    auto ms_since = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+
+    struct Stat {
+        double total = 0, max = 0;
+        int count = 0;
+        void add(double ms) { total += ms; max = std::max(max, ms); ++count; }
+    } stop_stat, movetime_stat, ponder_stat;
+
+    for (int round = 0; round < rounds; ++round) {
+        // Stop at different depths into the search: 10, 40, 70, ... ms
+        const auto delay = std::chrono::milliseconds(10 + 30 * (round % 8));
+
+        for (const char* fen : BENCH_FENS) {
+            board.set_fen(fen);
+
+            SearchParams params;
+            params.depth = MAX_DEPTH;
+            params.infinite = true;
+            pool.start_search(board, params, on_done);
+            std::this_thread::sleep_for(delay);
+            auto signal = Clock::now();
+            pool.stop();
+            pool.wait_for_search_finished();
+            stop_stat.add(ms_since(signal, done));
+
+            params.infinite = false;
+            params.time_ms = MOVETIME;
+            auto start = Clock::now();
+            pool.start_search(board, params, on_done);
+            pool.wait_for_search_finished();
+            movetime_stat.add(ms_since(start, done) - MOVETIME);
+
+            params.ponder = true;
+            pool.start_search(board, params, on_done);
+            std::this_thread::sleep_for(delay);
+            signal = Clock::now();
+            pool.ponderhit();
+            pool.wait_for_search_finished();
+            ponder_stat.add(ms_since(signal, done) - MOVETIME);
+        }
+    }
+
+    auto report = [](const char* name, const Stat& stat) {
+        std::cout << name << " avg " << stat.total / stat.count << " ms"
+                  << " max " << stat.max << " ms\n";
+    };
+    std::cout << "threads " << threads << " searches " << stop_stat.count << "\n";
+    report("stop -> bestmove     ", stop_stat);
+    report("movetime overshoot   ", movetime_stat);
+    report("ponderhit overshoot  ", ponder_stat);
+    return stop_stat.max < 5.0 ? 0 : 1;
+}
+
+// ===== Node Budget =====
+// `go nodes` on every bench position three times, each from a cleared TT
+// and cleared histories: twice on a Searcher, once through a one-thread
+// pool as the UCI loop runs it. Without a clock all three must stop at the
+// budget and agree in everything but the time taken. Prints each result and
+// the NPS; returns the number of positions where the runs differ.
+int bench_nodes(uint64_t nodes) {
+    Evaluator evaluator;
+    Searcher searcher(evaluator);
+    ThreadPool pool(evaluator);
+    Board board;
+
+    SearchParams params;
+    params.depth = MAX_DEPTH;
+    params.use_time = false;
+    params.nodes = nodes;
+
+    auto same = [](const SearchResult& a, const SearchResult& b) {
+        return a.best_move == b.best_move && a.score == b.score && a.nodes == b.nodes
+            && a.depth == b.depth && a.cutoffs == b.cutoffs && a.first_move_cutoffs == b.first_move_cutoffs
+            && std::equal(a.pv.begin(), a.pv.end(), b.pv.begin(), b.pv.end());
+    };
+
+    int mismatches = 0;
+    double seconds = 0;
+    uint64_t total_nodes = 0;
+    for (const char* fen : BENCH_FENS) {
+        board.set_fen(fen);
+        SearchResult runs[3];
+        for (int run = 0; run < 3; ++run) {
+            TT.clear();
+            auto start = std::chrono::steady_clock::now();
+            if (run < 2) {
+                searcher.clear();
+                runs[run] = searcher.search(board, params);
+            } else {
+                pool.clear();
+                pool.start_search(board, params);
+                pool.wait_for_search_finished();
+                runs[run] = pool.result();
+            }
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            total_nodes += runs[run].nodes;
+        }
+
+        const bool ok = runs[0].nodes == nodes && same(runs[0], runs[1]) && same(runs[0], runs[2]);
+        mismatches += !ok;
+        std::cout << (ok ? "ok  " : "DIFF") << " depth " << runs[0].depth << " score " << runs[0].score
+                  << " best " << move_to_uci(runs[0].best_move) << " nodes " << runs[0].nodes
+                  << "  " << fen << "\n";
+    }
+
+    std::cout << "nodes " << total_nodes << " time " << int(seconds * 1000) << " ms"
+              << " nps " << uint64_t(total_nodes / seconds) << "\n"
+              << (mismatches ? "node-limited searches differ between runs\n"
+                             : "node-limited searches are reproducible\n");
+    return mismatches;
+}
+
+// ===== Time Management =====
+// Plays the bench positions out against itself on simulated clocks. Each
+// move's wall time from go to bestmove, plus LAG_MS for the GUI and the
+// network, comes off the mover's clock; then the increment goes on, and
+// under a movestogo control the base time again every `moves_to_go` moves.
+// A game ends at mate, stalemate or GAME_PLIES. For every time control it
+// reports flags, the lowest clock left after a move, time used against the
+// optimum and the worst overshoot of the maximum. Returns non-zero on any
+// flag.
+int bench_clock(int games) {
+    using Clock = std::chrono::steady_clock;
+    constexpr double LAG_MS = 5;  // Within the default Move Overhead
+    constexpr int GAME_PLIES = 80;
+
+    struct Control {
+        const char* name;
+        int base;
+        int increment;
+        int moves_to_go;
+    };
+    const Control controls[] = {
+        {"1s+10ms", 1000, 10, 0},
+        {"2s sudden death", 2000, 0, 0},
+        {"200ms+50ms", 200, 50, 0},
+        {"500ms per 10 moves", 500, 0, 10},
+    };
+    const int positions = int(sizeof(BENCH_FENS) / sizeof(BENCH_FENS[0]));
+
+    Evaluator evaluator;
+    ThreadPool pool(evaluator);
+    Board board;
+    int total_flags = 0;
+
+    for (const Control& control : controls) {
+        int moves = 0;
+        int flags = 0;
+        double lowest = control.base;
+        double used_total = 0;
+        double optimum_total = 0;
+        double worst_overshoot = -1e9;
+
+        for (int game = 0; game < games; ++game) {
+            board.set_fen(BENCH_FENS[game % positions]);
+            TT.clear();
+            double clock[NUM_COLORS] = {double(control.base), double(control.base)};
+
+            for (int ply = 0; ply < GAME_PLIES; ++ply) {
+                MoveList legal;
+                board.generate_legal_moves(legal);
+                if (legal.empty()) break;
+
+                const Color us = board.get_side_to_move();
+                const int move_number = ply / 2;  // This side's moves so far
+                SearchParams params;
+                params.depth = MAX_DEPTH;
+                for (Color color : {WHITE, BLACK}) {
+                    params.time_left[color] = int(clock[color]);
+                    params.increment[color] = control.increment;
+                }
+                if (control.moves_to_go) {
+                    params.moves_to_go = control.moves_to_go - move_number % control.moves_to_go;
+                }
+                TimeManager time;
+                time.init(params, us);
+
+                const auto start = Clock::now();
+                pool.start_search(board, params);
+                pool.wait_for_search_finished();
+                const double used = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+                ++moves;
+                used_total += used;
+                optimum_total += double(time.optimum());
+                worst_overshoot = std::max(worst_overshoot, used - double(time.maximum()));
+
+                clock[us] -= used + LAG_MS;
+                if (clock[us] < 0) {
+                    ++flags;
+                    break;
+                }
+                lowest = std::min(lowest, clock[us]);
+                clock[us] += control.increment;
+                if (control.moves_to_go && params.moves_to_go == 1) clock[us] += control.base;
+
+                board.make_move(pool.result().best_move);
+            }
+        }
+
+        total_flags += flags;
+        std::cout << control.name << ": games " << games << " moves " << moves << " flags " << flags
+                  << std::fixed << std::setprecision(1)
+                  << " lowest clock " << lowest << " ms"
+                  << " used/optimum " << std::setprecision(2) << used_total / std::max(1.0, optimum_total)
+                  << " worst overshoot of maximum " << std::setprecision(1) << worst_overshoot << " ms\n"
+                  << std::defaultfloat;
+    }
+    return total_flags ? 1 : 0;
+}
+
+// ===== Draws =====
+// Random games that mostly shuffle pieces, with the odd null move. At every
+// position Board::is_draw and Board::has_upcoming_repetition are checked
+// against a brute force over the game's own key history: count the earlier
+// occurrences of the position, and make every quiet piece move to see
+// whether it lands on one. Returns non-zero on any disagreement.
+int bench_draw(int games) {
+    constexpr int GAME_PLIES = 300;
+    std::mt19937 rng(2024);
+    Board board;
+    uint64_t positions = 0, draws = 0, upcoming = 0, errors = 0;
+
+    for (int game = 0; game < games; ++game) {
+        board.set_fen(BENCH_FENS[game % std::size(BENCH_FENS)]);
+        // Keys since the last capture, pawn move or null move, current last
+        std::vector<uint64_t> history = {board.get_zobrist_key()};
+        int fifty = board.get_halfmove_clock();  // Counted here from the FEN's
+
+        for (int game_ply = 0; game_ply < GAME_PLIES; ++game_ply) {
+            const uint64_t key = board.get_zobrist_key();
+            const int n = int(history.size()) - 1;
+            const int ply = std::uniform_int_distribution<int>(0, n + 1)(rng);
+            MoveList legal;
+            board.generate_legal_moves(legal);
+
+            // Brute-force draw: the fifty-move rule unless mated, a repetition
+            // inside the last `ply` plies, or a third occurrence
+            bool draw = fifty >= 100 && (!board.checkers() || !legal.empty());
+            int earlier = 0;
+            for (int i = 2; i <= n; i += 2) {
+                if (history[n - i] == key && (i < ply || ++earlier == 2)) draw = true;
+            }
+
+            // Brute-force upcoming repetition: a quiet piece move of ours back
+            // to a position within the last `ply` plies
+            bool repeat = false;
+            MoveList pseudo_legal;
+            board.generate_pseudo_legal_moves(pseudo_legal);
+            for (const Move& move : pseudo_legal) {
+                if (board.piece_at(move.from()).type == PAWN || move.is_castling() || move.promotion() != NONE_PIECE
+                    || !board.is_empty(move.to())) continue;
+                board.make_move(move);
+                for (int i = 1; i < std::min(n + 1, ply); i += 2) {
+                    repeat |= history[n - i] == board.get_zobrist_key();
+                }
+                board.unmake_move(move);
+            }
+
+            const bool draw_ok = board.is_draw(ply) == draw;
+            const bool repeat_ok = board.has_upcoming_repetition(ply) == repeat;
+            if (!draw_ok || !repeat_ok) {
+                if (errors++ < 10) {
+                    std::cout << "mismatch " << (draw_ok ? "" : "is_draw ") << (repeat_ok ? "" : "upcoming ")
+                              << "ply " << ply << " at ply " << game_ply << " of game " << game << "\n";
+                }
+            }
+            ++positions;
+            draws += draw;
+            upcoming += repeat;
+            if (legal.empty()) break;
+
+            // Quiet piece moves nine times in ten, to make repetitions likely
+            std::vector<Move> quiet;
+            for (const Move& move : legal) {
+                if (board.piece_at(move.from()).type != PAWN && board.is_empty(move.to()) && !move.is_castling()) {
+                    quiet.push_back(move);
+                }
+            }
+            if (!board.checkers() && std::uniform_int_distribution<int>(0, 49)(rng) == 0) {
+                board.make_null_move();
+                history = {board.get_zobrist_key()};
+                ++fifty;
+                continue;
+            }
+            const bool shuffle = !quiet.empty() && std::uniform_int_distribution<int>(0, 9)(rng) != 0;
+            const Move move = shuffle ? quiet[rng() % quiet.size()] : legal[rng() % legal.size()];
+            const bool reversible = board.piece_at(move.from()).type != PAWN && board.is_empty(move.to())
+                                 && !move.is_en_passant();
+            board.make_move(move);
+            if (reversible) {
+                ++fifty;
+                history.push_back(board.get_zobrist_key());
+            } else {
+                fifty = 0;
+                history = {board.get_zobrist_key()};
+            }
+        }
+    }
+
+    std::cout << positions << " positions, " << draws << " draws, " << upcoming << " upcoming repetitions, "
+              << errors << " mismatches\n";
+    return errors ? 1 : 0;
+}
+
+// ===== Perft =====
+// Legality the way Board::generate_legal_moves used to decide it: make each
+// pseudo-legal move and reject it if the mover's king is left in check.
+void make_test_legal_moves(Board& board, MoveList& legal) {
+    MoveList pseudo_legal;
+    board.generate_pseudo_legal_moves(pseudo_legal);
+
+    Color us = board.get_side_to_move();
+    for (const Move& move : pseudo_legal) {
+        board.make_move(move);
+        if (!board.is_in_check(us)) {
+            legal.push_back(move);
+        }
+        board.unmake_move(move);
+    }
+}
+
+template <bool MakeTest>
+uint64_t perft(Board& board, int depth) {
+    MoveList moves;
+    if constexpr (MakeTest) {
+        make_test_legal_moves(board, moves);
+    } else {
+        board.generate_legal_moves(moves);
+    }
+
+    if (depth <= 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        board.make_move(move);
+        nodes += perft<MakeTest>(board, depth - 1);
+        board.unmake_move(move);
+    }
+    return nodes;
+}
+
+template <bool MakeTest>
+uint64_t timed_perft(Board& board, int depth, double& seconds) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = perft<MakeTest>(board, depth);
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return nodes;
+}
+
+// Runs perft over the bench positions once with make-and-test legality and
+// once with pin/check-mask legality, and reports the throughput of each.
+int bench_perft(int depth) {
+    Board board;
+    uint64_t make_test_nodes = 0, pin_mask_nodes = 0;
+    double make_test_time = 0, pin_mask_time = 0;
+
+    for (const char* fen : BENCH_FENS) {
+        board.set_fen(fen);
+        uint64_t a = timed_perft<true>(board, depth, make_test_time);
+        uint64_t b = timed_perft<false>(board, depth, pin_mask_time);
+        make_test_nodes += a;
+        pin_mask_nodes += b;
+        std::cout << "make-test " << a << " pin-mask " << b << "  " << fen << "\n";
+    }
+
+    std::cout << "make-test: " << make_test_nodes << " nodes "
+              << uint64_t(make_test_nodes / make_test_time) << " nps\n"
+              << "pin-mask:  " << pin_mask_nodes << " nodes "
+              << uint64_t(pin_mask_nodes / pin_mask_time) << " nps\n"
+              << "speedup:   " << (make_test_time / pin_mask_time) << "x\n";
+    return 0;
+}
+
+// ===== Opening Book =====
+// A two-move Polyglot book: 1. e4 from the start position, 1... e5 after it
+std::string write_test_book() {
+    const std::string path = (std::filesystem::temp_directory_path() / "viperchess-bench-book.bin").string();
+    Board board;
+    board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    std::ofstream file(path, std::ios::binary);
+    for (const auto& [from, to] : {std::pair{E2, E4}, std::pair{E7, E5}}) {
+        // key, move, weight, learn; big-endian
+        const uint64_t fields[] = {board.get_zobrist_key(), uint64_t(from << 6 | to), 1, 0};
+        const int sizes[] = {8, 2, 2, 4};
+        for (int f = 0; f < 4; ++f) {
+            for (int i = sizes[f] - 1; i >= 0; --i) file.put(char(fields[f] >> (8 * i) & 0xFF));
+        }
+        MoveList legal;
+        board.generate_legal_moves(legal);
+        for (const Move& move : legal) {
+            if (move.from() == from && move.to() == to) board.make_move(move);
+        }
+    }
+    return path;
+}
+
+// `position` sets up exactly the position it is given, whatever the book
+// holds for it, and OwnBook decides whether a search may answer from the
+// book. Returns non-zero on failure.
+int bench_book() {
+    const std::string path = write_test_book();
+    Board expected;
+    expected.set_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+
+    Board board;
+    Evaluator evaluator;
+    UCI uci(board, evaluator);
+    std::istringstream option("name BookFile value " + path);
+    uci.handle_setoption(option);
+    uci.handle_position("startpos moves e2e4");
+    const bool position_ok = board.get_side_to_move() == BLACK
+                          && board.get_zobrist_key() == expected.get_zobrist_key();
+    std::cout << (position_ok ? "ok   " : "FAIL ") << "position startpos moves e2e4 with a book loaded\n";
+
+    // The search plays 1. e4 from the book, at depth 0, unless OwnBook is
+    // off and it has to search
+    OpeningBook book;
+    book.load(path);
+    Searcher searcher(evaluator, &book);
+    Board start;
+    start.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    int failures = !position_ok;
+    for (bool use_book : {true, false}) {
+        SearchParams params;
+        params.depth = 2;
+        params.use_time = false;
+        params.use_book = use_book;
+        const SearchResult result = searcher.search(start, params);
+        const bool from_book = result.depth == 0 && move_to_uci(result.best_move) == "e2e4";
+        const bool ok = from_book == use_book;
+        failures += !ok;
+        std::cout << (ok ? "ok   " : "FAIL ") << "OwnBook " << (use_book ? "true" : "false") << ": "
+                  << move_to_uci(result.best_move) << " at depth " << result.depth << "\n";
+    }
+
+    std::filesystem::remove(path);
+    return failures ? 1 : 0;
+}
+
+// ===== Hash Keys =====
+// Positions and keys from the Polyglot book format specification
+struct ReferenceKey {
+    const char* moves;
+    uint64_t key;
+};
+
+const ReferenceKey POLYGLOT_KEYS[] = {
+    {"", 0x463b96181691fc9cULL},
+    {"e2e4", 0x823c9b50fd114196ULL},
+    {"e2e4 d7d5", 0x0756b94461c50fb0ULL},
+    {"e2e4 d7d5 e4e5", 0x662fafb965db29d4ULL},
+    {"e2e4 d7d5 e4e5 f7f5", 0x22a48b5a8e47ff78ULL},
+    {"e2e4 d7d5 e4e5 f7f5 e1e2", 0x652a607ca3f242c1ULL},
+    {"e2e4 d7d5 e4e5 f7f5 e1e2 e8f7", 0x00fdd303c946bdd9ULL},
+    {"a2a4 b7b5 h2h4 b5b4 c2c4", 0x3c8123ea7b067637ULL},
+    {"a2a4 b7b5 h2h4 b5b4 c2c4 b4c3 a1a3", 0x5c3f9b829b279560ULL},
+};
+
+// Walks the legal move tree and compares the incrementally updated keys
+// with keys recomputed from the board. Returns the number of mismatches.
+uint64_t check_keys(Board& board, int depth) {
+    uint64_t pawn_key = 0, material_key = 0;
+    for (Color c : {WHITE, BLACK}) {
+        for (int pt = PAWN; pt <= KING; ++pt) {
+            uint64_t pieces = board.get_pieces(c, PieceType(pt));
+            for (int n = 0; n < count_bits(pieces); ++n) {
+                material_key ^= Zobrist::piece_keys[pt][c][n];
+            }
+            while (pt == PAWN && pieces) {
+                pawn_key ^= Zobrist::piece_keys[PAWN][c][Board::pop_lsb(pieces)];
+            }
+        }
+    }
+
+    uint64_t errors = (board.get_zobrist_key() != board.zobrist_key())
+                    + (board.get_pawn_key() != pawn_key)
+                    + (board.get_material_key() != material_key);
+    if (depth == 0) return errors;
+
+    MoveList moves;
+    board.generate_legal_moves(moves);
+    for (const Move& move : moves) {
+        board.make_move(move);
+        errors += check_keys(board, depth - 1);
+        board.unmake_move(move);
+    }
+    return errors;
+}
+
+int bench_keys(int depth) {
+    Board board;
+    int failures = 0;
+
+    for (const ReferenceKey& ref : POLYGLOT_KEYS) {
+        board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        std::istringstream moves(ref.moves);
+        std::string token;
+        while (moves >> token) {
+            MoveList legal;
+            board.generate_legal_moves(legal);
+            for (const Move& move : legal) {
+                if (move_to_uci(move) == token) {
+                    board.make_move(move);
+                    break;
+                }
+            }
+        }
+        bool ok = board.get_zobrist_key() == ref.key;
+        failures += !ok;
+        std::cout << (ok ? "ok   " : "FAIL ") << std::hex << board.get_zobrist_key()
+                  << std::dec << "  startpos " << ref.moves << "\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const char* fen : BENCH_FENS) {
+        board.set_fen(fen);
+        uint64_t errors = check_keys(board, depth);
+        failures += errors != 0;
+        std::cout << "mismatches " << errors << "  " << fen << "\n";
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << (failures ? "FAILED" : "all keys match")
+              << " (" << int(seconds * 1000) << " ms)\n";
+    return failures ? 1 : 0;
+}
+
+// ===== Move Encodings =====
+// Moves in the Polyglot and Fathom formats, worked out by hand from their
+// specifications: to in bits 0-5, from in bits 6-11, promotion in 12-14.
+// Polyglot numbers promotions N=1 .. Q=4 and writes castling as the king
+// taking its rook; Fathom numbers them Q=1 .. N=4.
+struct ReferenceEncoding {
+    Move move;
+    uint16_t encoded;
+};
+
+constexpr uint16_t encode(Square from, Square to, unsigned promotion = 0) {
+    return uint16_t(to | from << 6 | promotion << 12);
+}
+
+const ReferenceEncoding POLYGLOT_MOVES[] = {
+    {Move(E2, E4), encode(E2, E4)},
+    {Move(E7, E8, KNIGHT), encode(E7, E8, 1)},
+    {Move(B2, A1, QUEEN), encode(B2, A1, 4)},
+    {Move::make(E1, G1, Move::CASTLING), encode(E1, H1)},
+    {Move::make(E1, C1, Move::CASTLING), encode(E1, A1)},
+    {Move::make(E8, G8, Move::CASTLING), encode(E8, H8)},
+    {Move::make(D5, E6, Move::EN_PASSANT), encode(D5, E6)},
+};
+
+const ReferenceEncoding SYZYGY_MOVES[] = {
+    {Move(G1, F3), encode(G1, F3)},
+    {Move(A7, A8, QUEEN), encode(A7, A8, 1)},
+    {Move(B7, A8, ROOK), encode(B7, A8, 2)},
+    {Move(H2, H1, BISHOP), encode(H2, H1, 3)},
+    {Move(C2, D1, KNIGHT), encode(C2, D1, 4)},
+    {Move(D5, E6), encode(D5, E6)},  // En passant comes unflagged
+};
+
+int bench_encodings() {
+    int failures = 0;
+    for (const ReferenceEncoding& ref : POLYGLOT_MOVES) {
+        const bool ok = ref.move.to_polyglot() == ref.encoded;
+        failures += !ok;
+        std::cout << (ok ? "ok   " : "FAIL ") << "to_polyglot   " << move_to_uci(ref.move) << "\n";
+    }
+    for (const ReferenceEncoding& ref : SYZYGY_MOVES) {
+        const bool ok = Move::from_syzygy(ref.encoded) == ref.move;
+        failures += !ok;
+        std::cout << (ok ? "ok   " : "FAIL ") << "from_syzygy   " << move_to_uci(ref.move) << "\n";
+    }
+    std::cout << (failures ? "FAILED" : "all encodings match") << "\n";
+    return failures ? 1 : 0;
+}
+
+// ===== Move Picker =====
+// At every node of a perft tree: Board::is_pseudo_legal accepts everything
+// the generator produces and, of the parent's and grandparent's moves
+// (foreign here, the latter for the same side, like killers), exactly those
+// the generator would produce; the main picker, fed foreign and legal moves
+// as TT move, killers and counter-move, hands out every legal move exactly
+// once; the quiescence picker hands out exactly the legal captures.
+uint64_t check_picker(Board& board, int depth, const MoveList& parent, const MoveList& foreign) {
+    static const ButterflyHistory history = {};
+    static const CaptureHistory capture_history = {};
+    const PieceToHistory* const continuation[2] = {nullptr, nullptr};
+    auto sorted = [](std::vector<uint16_t> v) { std::sort(v.begin(), v.end()); return v; };
+
+    MoveList pseudo;
+    MoveGen::generate<CAPTURES>(board, pseudo);
+    MoveGen::generate<QUIETS>(board, pseudo);
+    uint64_t errors = 0;
+    for (const Move& move : pseudo) {
+        errors += !board.is_pseudo_legal(move);
+    }
+    for (const MoveList* list : {&parent, &foreign}) {
+        for (const Move& move : *list) {
+            bool generated = std::find(pseudo.begin(), pseudo.end(), move) != pseudo.end();
+            errors += board.is_pseudo_legal(move) != generated;
+        }
+    }
+
+    MoveList legal;
+    board.generate_legal_moves(legal);
+    std::vector<uint16_t> expected, expected_captures;
+    for (const Move& move : legal) {
+        expected.push_back(move.raw());
+        if (!board.is_empty(move.to()) || move.is_en_passant() || move.promotion() == QUEEN) {
+            expected_captures.push_back(move.raw());
+        }
+    }
+
+    const Bitboard pinned = board.pinned_pieces(board.get_side_to_move());
+    const Bitboard checkers = board.checkers();
+    auto drain = [&](MovePicker& picker) {
+        std::vector<uint16_t> out;
+        for (Move move = picker.next_move(); move.is_valid(); move = picker.next_move()) {
+            if (board.is_legal(move, pinned, checkers)) out.push_back(move.raw());
+        }
+        return sorted(out);
+    };
+
+    auto pick = [&](size_t i) { return i < foreign.size() ? foreign[i] : Move::none(); };
+    const Move foreign_killers[2] = {pick(1), pick(2)};
+    MovePicker from_foreign(board, pick(0), foreign_killers, pick(3), history, capture_history, continuation);
+    errors += drain(from_foreign) != sorted(expected);
+
+    if (!legal.empty()) {
+        const Move legal_killers[2] = {legal[0], legal[legal.size() - 1]};
+        MovePicker from_legal(board, legal[legal.size() / 2], legal_killers, legal[legal.size() / 3],
+                              history, capture_history, continuation);
+        errors += drain(from_legal) != sorted(expected);
+    }
+
+    MovePicker captures(board, capture_history);
+    errors += drain(captures) != sorted(expected_captures);
+
+    if (depth == 0) return errors;
+    for (const Move& move : legal) {
+        board.make_move(move);
+        errors += check_picker(board, depth - 1, pseudo, parent);
+        board.unmake_move(move);
+    }
+    return errors;
+}
+
+int bench_picker(int depth) {
+    Board board;
+    uint64_t total = 0;
+    for (const char* fen : BENCH_FENS) {
+        board.set_fen(fen);
+        uint64_t errors = check_picker(board, depth, MoveList(), MoveList());
+        total += errors;
+        std::cout << "mismatches " << errors << "  " << fen << "\n";
+    }
+    std::cout << (total ? "FAILED" : "picker and is_pseudo_legal agree with the generator") << "\n";
+    return total ? 1 : 0;
+}
+
+// ===== Static Exchange Evaluation =====
+// Exchanges worked out by hand with piece_value. Each is checked as
+// see_ge(value) and !see_ge(value + 1), so the exact outcome is pinned down.
+struct SeeCase {
+    const char* fen;
+    const char* move;
+    int value;
+};
+
+const SeeCase SEE_CASES[] = {
+    {"4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1", "e4d5", 100},            // Free pawn
+    {"4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1", "d1d5", -400},          // Rook for a pawn
+    {"4k3/8/2p5/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5", -300},        // Rook x-rays a rook
+    {"4k3/3n4/8/4p3/8/2B5/1Q6/4K3 w - - 0 1", "c3e5", 90},         // Queen x-rays a bishop
+    {"4k3/3n4/8/4p3/8/2B5/8/4K3 w - - 0 1", "c3e5", -230},         // Same, no queen
+    {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6", 100},            // En passant
+    {"3rk3/8/8/3P4/8/8/8/3QK3 b - - 0 1", "d8d5", -400},           // Black to move
+    {"4k3/8/8/8/8/8/3p4/3QK3 w - - 0 1", "d1d2", 100},             // Free pawn, king alongside
+    {"3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5", -400},       // Doubled rooks on both sides
+    {"4k3/3n4/2n5/4p3/8/2B2N2/1Q6/4K3 w - - 0 1", "f3e5", 90},     // Bishop's recapture uncovers the queen
+    {"4k3/3n4/2n5/4p3/8/5N2/4R3/4Q1K1 w - - 0 1", "f3e5", -80},   // Rook's recapture uncovers the queen
+    {"4k3/8/8/8/8/4n3/8/R3K3 w - - 0 1", "a1a7", 0},               // Quiet move to a safe square
+    {"4k3/8/1n6/8/8/8/8/R3K3 w - - 0 1", "a1a4", -500},            // Quiet move onto a square a knight covers
+};
+
+int bench_see() {
+    Board board;
+    int failures = 0;
+    for (const SeeCase& c : SEE_CASES) {
+        board.set_fen(c.fen);
+        MoveList legal;
+        board.generate_legal_moves(legal);
+        Move move = Move::none();
+        for (const Move& m : legal) {
+            if (move_to_uci(m) == c.move) move = m;
+        }
+        bool ok = move.is_valid() && board.see_ge(move, c.value) && !board.see_ge(move, c.value + 1);
+        failures += !ok;
+        std::cout << (ok ? "ok   " : "FAIL ") << c.move << " " << c.value << "  " << c.fen << "\n";
+    }
+
+    // A king may not capture onto a defended square, so that exchange ends
+    // before it starts
+    board.set_fen("4k3/8/8/8/8/4p3/3p4/4K3 w - - 0 1");
+    const Move king_takes(E1, D2);
+    bool ok = !board.see_ge(king_takes, 0);
+    failures += !ok;
+    std::cout << (ok ? "ok   " : "FAIL ") << "e1d2 loses the king  4k3/8/8/8/8/4p3/3p4/4K3 w - - 0 1\n";
+
+    std::cout << (failures ? "FAILED" : "all exchanges match") << "\n";
+    return failures ? 1 : 0;
+}
+
+// ===== Slider Lookups =====
+// Looks up rook and bishop attacks for every square against a fixed set of
+// random occupancies. The backend is chosen at build time, so compare by
+// configuring once with -DVIPERCHESS_PEXT=ON and once with OFF.
+int bench_sliders(int millions) {
+    Board board;
+
+    // Sparse-ish occupancies, like a middlegame board
+    std::mt19937_64 rng(2024);
+    std::vector<uint64_t> occupancies(1024);
+    for (uint64_t& occ : occupancies) {
+        occ = rng() & rng();
+    }
+
+    const uint64_t lookups = uint64_t(millions) * 1000000;
+    const uint64_t rounds = lookups / (occupancies.size() * 64 * 2) + 1;
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < rounds; ++r) {
+        for (uint64_t occ : occupancies) {
+            for (Square sq = A1; sq < NUM_SQUARES; sq = Square(sq + 1)) {
+                checksum ^= board.get_rook_attacks(sq, occ);
+                checksum += board.get_bishop_attacks(sq, occ);
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t done = rounds * occupancies.size() * 64 * 2;
+
+    std::cout << "backend " << SLIDER_BACKEND
+              << " table " << sizeof(slider_attacks) / 1024 << " KB"
+              << " lookups " << done
+              << " lookups/s " << uint64_t(done / seconds)
+              << " checksum " << std::hex << checksum << std::dec << "\n";
+    return 0;
+}
+
+// ===== Transposition Table =====
+// Random keys defeat every cache and, on a big table, the TLB too, so this
+// measures how the table's memory is laid out rather than the entry logic.
+int bench_tt(int mb) {
+    auto start = std::chrono::steady_clock::now();
+    TT.resize(mb);
+    double alloc_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::mt19937_64 rng(7);
+    const int count = 1 << 22;
+    for (int i = 0; i < count; ++i) {
+        TT.store(rng(), 1 + i % 16, 0, 0, Move::none(), EXACT);
+    }
+
+    std::vector<uint64_t> keys(count);
+    for (uint64_t& key : keys) {
+        key = rng();
+    }
+
+    TTData data;
+    int hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint64_t key : keys) {
+        hits += TT.probe(key, data);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "table " << mb << " MB"
+              << " allocate+clear " << int(alloc_seconds * 1000) << " ms"
+              << " probes/s " << uint64_t(count / seconds)
+              << " hits " << hits << "\n";
+    return 0;
+}
+
+} // namespace
+} // namespace ViperChess
+
+int main(int argc, char* argv[]) {
+    std::string name = argc > 1 ? argv[1] : "";
+
+    if (name == "alloc") {
+        return ViperChess::bench_alloc(argc > 2 ? std::stoi(argv[2]) : 4);
+    }
+
+    if (name == "perft") {
+        return ViperChess::bench_perft(argc > 2 ? std::stoi(argv[2]) : 4);
+    }
+
+    if (name == "search") {
+        return ViperChess::bench_search(argc > 2 ? std::stoi(argv[2]) : 5);
+    }
+
+    if (name == "encodings") {
+        return ViperChess::bench_encodings();
+    }
+
+    if (name == "keys") {
+        return ViperChess::bench_keys(argc > 2 ? std::stoi(argv[2]) : 4);
+    }
+
+    if (name == "smp") {
+        return ViperChess::bench_smp(argc > 2 ? std::stoi(argv[2]) : 7,
+                                     argc > 3 ? std::stoi(argv[3]) : 32);
+    }
+
+    if (name == "pool") {
+        return ViperChess::bench_pool(argc > 2 ? std::stoi(argv[2]) : 8,
+                                      argc > 3 ? std::stoi(argv[3]) : 1000);
+    }
+
+    if (name == "see") {
+        return ViperChess::bench_see();
+    }
+
+    if (name == "picker") {
+        return ViperChess::bench_picker(argc > 2 ? std::stoi(argv[2]) : 3);
+    }
+
+    if (name == "prune") {
+        return ViperChess::bench_prune(argc > 2 ? std::stoi(argv[2]) : 8);
+    }
+
+    if (name == "nodes") {
+        return ViperChess::bench_nodes(argc > 2 ? std::stoull(argv[2]) : 200000);
+    }
+
+    if (name == "book") {
+        return ViperChess::bench_book();
+    }
+
+    if (name == "clock") {
+        return ViperChess::bench_clock(argc > 2 ? std::stoi(argv[2]) : 2);
+    }
+
+    if (name == "draw") {
+        return ViperChess::bench_draw(argc > 2 ? std::stoi(argv[2]) : 200);
+    }
+
+    if (name == "stop") {
+        return ViperChess::bench_stop(argc > 2 ? std::stoi(argv[2]) : 1,
+                                      argc > 3 ? std::stoi(argv[3]) : 4);
+    }
+
+    if (name == "sliders") {
+        return ViperChess::bench_sliders(argc > 2 ? std::stoi(argv[2]) : 200);
+    }
+
+    if (name == "tt") {
+        return ViperChess::bench_tt(argc > 2 ? std::stoi(argv[2]) : 1024);
+    }
+
+    std::cerr << "usage: viperchess-bench alloc|book|clock|draw|encodings|keys|nodes|perft|picker|pool|prune|search|see|smp|sliders|stop|tt [args]\n";
+    return 1;
+}
@@ -1,929 +1,993 @@
-// board.cpp
-#include "board.hpp"
-#include "magic_bits.hpp" // Contains ROOK_MAGIC_NUMBERS, BISHOP_MAGIC_NUMBERS
-#include <sstream>
-#include <cctype>
-#include <iostream>
-#include <bitset>
-#include <cmath>
-
-namespace ViperChess {
-
-uint64_t Board::pawn_attack_table[NUM_COLORS][64] = {};
-uint64_t Board::knight_attack_table[64] = {};
-uint64_t Board::king_attack_table[64] = {};
-    
-constexpr Square operator+(Square s, int i) { return Square(int(s) + i); }
-constexpr Square operator-(Square s, int i) { return Square(int(s) - i); }
-Square& operator++(Square& s) { return s = Square(int(s) + 1); }
-Square& operator--(Square& s) { return s = Square(int(s) - 1); }
-Square operator++(Square& s, int) { Square tmp = s; ++s; return tmp; }
-Square operator--(Square& s, int) { Square tmp = s; --s; return tmp; }
-
-// Enum operators for PieceType
-constexpr PieceType operator+(PieceType pt, int i) { return PieceType(int(pt) + i); }
-constexpr PieceType operator-(PieceType pt, int i) { return PieceType(int(pt) - i); }
-PieceType& operator++(PieceType& pt) { return pt = PieceType(int(pt) + 1); }
-PieceType& operator--(PieceType& pt) { return pt = PieceType(int(pt) - 1); }
-PieceType operator++(PieceType& pt, int) { PieceType tmp = pt; ++pt; return tmp; }
-PieceType operator--(PieceType& pt, int) { PieceType tmp = pt; --pt; return tmp; }
-
-// Enum operators for Color
-constexpr Color operator+(Color c, int i) { return Color(int(c) + i); }
-constexpr Color operator-(Color c, int i) { return Color(int(c) - i); }
-Color& operator++(Color& c) { return c = Color(int(c) + 1); }
-Color& operator--(Color& c) { return c = Color(int(c) - 1); }
-Color operator++(Color& c, int) { Color tmp = c; ++c; return tmp; }
-Color operator--(Color& c, int) { Color tmp = c; --c; return tmp; }
-
-// ===== Piece Constants =====
-const Piece Piece::NONE     = {NONE_PIECE, ViperChess::Color::NONE};
-const Piece Piece::W_PAWN   = {PAWN, WHITE};
-const Piece Piece::B_PAWN   = {PAWN, BLACK};
-const Piece Piece::W_KNIGHT = {KNIGHT, WHITE};
-const Piece Piece::B_KNIGHT = {KNIGHT, BLACK};
-const Piece Piece::W_BISHOP = {BISHOP, WHITE};
-const Piece Piece::B_BISHOP = {BISHOP, BLACK};
-const Piece Piece::W_ROOK   = {ROOK, WHITE};
-const Piece Piece::B_ROOK   = {ROOK, BLACK};
-const Piece Piece::W_QUEEN  = {QUEEN, WHITE};
-const Piece Piece::B_QUEEN  = {QUEEN, BLACK};
-const Piece Piece::W_KING   = {KING, WHITE};
-const Piece Piece::B_KING   = {KING, BLACK};
-
-// ===== Magic Bitboard Tables =====
-Magic rook_magics[64];
-Magic bishop_magics[64];
-uint64_t rook_attacks[64][4096];
-uint64_t bishop_attacks[64][512];
-
-// ===== Board Initialization =====
-Board::Board() : m_side_to_move(WHITE) {
-    Zobrist::init();
-    static bool initialized = false;
-    if (!initialized) {
-        init_magics();
-        init_attack_tables();  // Add this line
-        initialized = true;
-    }
-    // Initialize empty board
-    m_squares.fill(Piece::NONE);
-    for (auto& color : m_pieces) {
-        for (auto& piece : color) {
-            piece = 0;
-        }
-    }
-    set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-}
-
-Square Board::pop_lsb(uint64_t& bb) 
-{
-        Square sq = Square(__builtin_ctzll(bb));
-        bb &= bb - 1; // Clear the least significant bit
-        return sq;
-}
-
-void Board::set_fen(const std::string& fen) {
-    std::istringstream iss(fen);
-    std::string token;
-    Square sq = A8;
-
-    // Clear the board first
-    m_squares.fill(Piece::NONE);
-    for (auto& color : m_pieces) {
-        for (auto& piece : color) {
-            piece = 0;
-        }
-    }
-    m_castling_rights = 0;  // Reset all castling rights
-    m_en_passant = NUM_SQUARES; // Indicates no en passant
-    m_halfmove_clock = 0;
-    m_fullmove_number = 1;
-
-    // 1. Piece placement
-    iss >> token;
-    for (char c : token) {
-        if (c == '/') {
-            sq = sq - 16; // Move to the beginning of the next rank
-        } else if (isdigit(c)) {
-            sq = sq + (c - '0'); // Skip empty squares
-        } else {
-            Color color = isupper(c) ? WHITE : BLACK;
-            PieceType type = char_to_piece(toupper(c));
-            m_squares[sq] = {type, color};
-            m_pieces[color][type] |= (1ULL << sq);
-            ++sq;
-        }
-    }
-
-    // 2. Active color
-    iss >> token;
-    m_side_to_move = (token == "w") ? WHITE : BLACK;
-
-    // 3. Castling availability
-    iss >> token;
-    if (token != "-") {
-        for (char c : token) {
-            switch (c) {
-                case 'K': m_castling_rights |= (1 << WHITE_OO); break;
-                case 'Q': m_castling_rights |= (1 << WHITE_OOO); break;
-                case 'k': m_castling_rights |= (1 << BLACK_OO); break;
-                case 'q': m_castling_rights |= (1 << BLACK_OOO); break;
-            }
-        }
-    }
-
-    // 4. En passant target square
-    iss >> token;
-    if (token != "-") {
-        int file = token[0] - 'a';
-        int rank = token[1] - '1';
-        m_en_passant = Square(rank * 8 + file);
-    }
-
-    // 5. Halfmove clock (for 50-move rule)
-    iss >> token;
-    m_halfmove_clock = std::stoi(token);
-
-    // 6. Fullmove number (increments after black's move)
-    if (iss >> token) {
-        m_fullmove_number = std::stoi(token);
-    }
-}
-
-// ===== Magic Bitboard Initialization =====
-void Board::init() {}
-
-uint64_t Board::compute_rook_attacks(Square sq, uint64_t occupancy) {
-    uint64_t attacks = 0;
-    int r = sq / 8, f = sq % 8;
-    
-    // North
-    for (int i = r + 1; i < 8; ++i) {
-        attacks |= (1ULL << (8 * i + f));
-        if (occupancy & (1ULL << (8 * i + f))) break;
-    }
-    // South
-    for (int i = r - 1; i >= 0; --i) {
-        attacks |= (1ULL << (8 * i + f));
-        if (occupancy & (1ULL << (8 * i + f))) break;
-    }
-    // East
-    for (int j = f + 1; j < 8; ++j) {
-        attacks |= (1ULL << (8 * r + j));
-        if (occupancy & (1ULL << (8 * r + j))) break;
-    }
-    // West
-    for (int j = f - 1; j >= 0; --j) {
-        attacks |= (1ULL << (8 * r + j));
-        if (occupancy & (1ULL << (8 * r + j))) break;
-    }
-    
-    return attacks;
-}
-
-uint64_t Board::compute_bishop_attacks(Square sq, uint64_t occupancy) {
-    uint64_t attacks = 0;
-    int r = sq / 8, f = sq % 8;
-    
-    // Northeast
-    for (int i = r + 1, j = f + 1; i < 8 && j < 8; ++i, ++j) {
-        attacks |= (1ULL << (8 * i + j));
-        if (occupancy & (1ULL << (8 * i + j))) break;
-    }
-    // Southeast
-    for (int i = r - 1, j = f + 1; i >= 0 && j < 8; --i, ++j) {
-        attacks |= (1ULL << (8 * i + j));
-        if (occupancy & (1ULL << (8 * i + j))) break;
-    }
-    // Southwest
-    for (int i = r - 1, j = f - 1; i >= 0 && j >= 0; --i, --j) {
-        attacks |= (1ULL << (8 * i + j));
-        if (occupancy & (1ULL << (8 * i + j))) break;
-    }
-    // Northwest
-    for (int i = r + 1, j = f - 1; i < 8 && j >= 0; ++i, --j) {
-        attacks |= (1ULL << (8 * i + j));
-        if (occupancy & (1ULL << (8 * i + j))) break;
-    }
-    
-    return attacks;
-}
-
-void Board::init_magics() {
-    for (Square sq = A1; sq < NUM_SQUARES; ++sq) {
-        // Initialize rook magics
-        rook_magics[sq] = {
-            rook_mask(sq),
-            magic_bits::ROOK_MAGIC_NUMBERS[sq],
-            rook_attacks[sq],
-            64 - magic_bits::ROOK_INDEX_BITS[sq]
-        };
-
-        // Initialize bishop magics
-        bishop_magics[sq] = {
-            bishop_mask(sq),
-            magic_bits::BISHOP_MAGIC_NUMBERS[sq],
-            bishop_attacks[sq],
-            64 - magic_bits::BISHOP_INDEX_BITS[sq]
-        };
-
-        // Precompute attack tables
-        init_sliding_attacks(sq, true);  // Rooks
-        init_sliding_attacks(sq, false); // Bishops
-    }
-}
-
-void Board::reset_to_startpos() {
-    m_zobrist_key = 0;
-    
-    // Hash pieces
-    for (Square sq = A1; sq < NUM_SQUARES; ++sq) {
-        if (m_squares[sq].type != NONE_PIECE) {
-            m_zobrist_key ^= Zobrist::piece_keys[m_squares[sq].type][m_squares[sq].color][sq];
-        }
-    }
-    
-    // Hash side to move (if black)
-    if (m_side_to_move == BLACK) {
-        m_zobrist_key ^= Zobrist::side_key;
-    }
-    
-    // Hash castling rights
-    m_zobrist_key ^= Zobrist::castling_keys[m_castling_rights];
-    
-    // EP square (none in starting position)
-    m_en_passant = NUM_SQUARES;
-}
-
-namespace Zobrist {
-    uint64_t piece_keys[NUM_PIECE_TYPES][NUM_COLORS][NUM_SQUARES];
-    uint64_t side_key;
-    uint64_t castling_keys[16];
-    uint64_t ep_keys[NUM_SQUARES];
-
-    void init() {
-        std::mt19937_64 rng(123456); // Fixed seed for reproducibility
-        
-        for (PieceType pt = PAWN; pt <= KING; ++pt)
-            for (Color c = WHITE; c <= BLACK; ++c)
-                for (Square sq = A1; sq < NUM_SQUARES; ++sq)
-                    piece_keys[pt][c][sq] = rng();
-        
-        side_key = rng();
-        for (int i = 0; i < 16; ++i) castling_keys[i] = rng();
-        for (Square sq = A1; sq < NUM_SQUARES; ++sq) ep_keys[sq] = rng();
-    }
-}
-
-
-// Zobrist key implementation
-void Board::update_zobrist_key(Piece piece, Square sq) {
-    m_zobrist_key ^= Zobrist::piece_keys[piece.type][piece.color][sq];
-}
-
-// Combined bitboards
-uint64_t Board::get_white_pieces() const {
-    return m_pieces[WHITE][PAWN] | m_pieces[WHITE][KNIGHT] | 
-           m_pieces[WHITE][BISHOP] | m_pieces[WHITE][ROOK] | 
-           m_pieces[WHITE][QUEEN] | m_pieces[WHITE][KING];
-}
-
-uint64_t Board::get_black_pieces() const {
-    return m_pieces[BLACK][PAWN] | m_pieces[BLACK][KNIGHT] | 
-           m_pieces[BLACK][BISHOP] | m_pieces[BLACK][ROOK] | 
-           m_pieces[BLACK][QUEEN] | m_pieces[BLACK][KING];
-}
-
-// Individual piece types
-uint64_t Board::get_kings() const   { return m_pieces[WHITE][KING] | m_pieces[BLACK][KING]; }
-uint64_t Board::get_queens() const  { return m_pieces[WHITE][QUEEN] | m_pieces[BLACK][QUEEN]; }
-uint64_t Board::get_rooks() const   { return m_pieces[WHITE][ROOK] | m_pieces[BLACK][ROOK]; }
-uint64_t Board::get_bishops() const { return m_pieces[WHITE][BISHOP] | m_pieces[BLACK][BISHOP]; }
-uint64_t Board::get_knights() const { return m_pieces[WHITE][KNIGHT] | m_pieces[BLACK][KNIGHT]; }
-uint64_t Board::get_pawns() const   { return m_pieces[WHITE][PAWN] | m_pieces[BLACK][PAWN]; }
-
-// Castling rights for Syzygy
-int Board::get_castling_rights() const {
-    int rights = 0;
-    if (m_castling_rights & (1 << WHITE_OO)) rights |= 1;
-    if (m_castling_rights & (1 << WHITE_OOO)) rights |= 2;
-    if (m_castling_rights & (1 << BLACK_OO)) rights |= 4;
-    if (m_castling_rights & (1 << BLACK_OOO)) rights |= 8;
-    return rights;
-}
-
-void Board::init_sliding_attacks(Square sq, bool is_rook) {
-    Magic* m = is_rook ? &rook_magics[sq] : &bishop_magics[sq];
-    uint64_t mask = m->mask;
-    int bits = count_bits(mask);
-
-    for (int i = 0; i < (1 << bits); ++i) {
-        uint64_t occ = index_to_occupancy(i, bits, mask);
-        uint64_t attacks = is_rook ? compute_rook_attacks(sq, occ) 
-                                  : compute_bishop_attacks(sq, occ);
-        uint64_t idx = (occ * m->magic) >> m->shift;
-        
-        if (is_rook) {
-            rook_attacks[sq][idx] = attacks;
-        } else {
-            bishop_attacks[sq][idx] = attacks;
-        }
-    }
-}
-
-// ===== Attack Generation ====at
-uint64_t Board::get_rook_attacks(Square sq, uint64_t occupancy) const {
-    const Magic& m = rook_magics[sq];
-    occupancy &= m.mask;
-    occupancy *= m.magic;
-    occupancy >>= m.shift;
-    return m.attacks[occupancy];
-}
-
-uint64_t Board::get_bishop_attacks(Square sq, uint64_t occupancy) const {
-    const Magic& m = bishop_magics[sq];
-    occupancy &= m.mask;
-    occupancy *= m.magic;
-    occupancy >>= m.shift;
-    return m.attacks[occupancy];
-}
-
-uint64_t Board::get_queen_attacks(Square sq, uint64_t occupancy) const {
-    return get_rook_attacks(sq, occupancy) | 
-           get_bishop_attacks(sq, occupancy);
-}
-
-// ===== Helper Functions =====
-uint64_t rook_mask(Square sq) {
-    uint64_t mask = 0;
-    int r = sq / 8, f = sq % 8;
-    for (int i = r+1; i <= 6; ++i) mask |= (1ULL << (8*i + f));
-    for (int i = r-1; i >= 1; --i) mask |= (1ULL << (8*i + f));
-    for (int j = f+1; j <= 6; ++j) mask |= (1ULL << (8*r + j));
-    for (int j = f-1; j >= 1; --j) mask |= (1ULL << (8*r + j));
-    return mask;
-}
-
-uint64_t bishop_mask(Square sq) {
-    uint64_t mask = 0;
-    int r = sq / 8, f = sq % 8;
-    for (int i = r+1, j = f+1; i <= 6 && j <= 6; ++i, ++j) mask |= (1ULL << (8*i + j));
-    for (int i = r+1, j = f-1; i <= 6 && j >= 1; ++i, --j) mask |= (1ULL << (8*i + j));
-    for (int i = r-1, j = f+1; i >= 1 && j <= 6; --i, ++j) mask |= (1ULL << (8*i + j));
-    for (int i = r-1, j = f-1; i >= 1 && j >= 1; --i, --j) mask |= (1ULL << (8*i + j));
-    return mask;
-}
-
-int count_bits(uint64_t b) {
-    return __builtin_popcountll(b);
-}
-
-uint64_t index_to_occupancy(int index, int bits, uint64_t mask) {
-    uint64_t result = 0;
-    for (int i = 0; i < bits; ++i) {
-        int sq = __builtin_ctzll(mask);
-        mask &= mask - 1;
-        if (index & (1 << i)) result |= (1ULL << sq);
-    }
-    return result;
-}
-
-void Board::update_zobrist_piece(Piece piece, Square sq) {
-    m_zobrist_key ^= Zobrist::piece_keys[piece.type][piece.color][sq];
-}
-
-void Board::update_zobrist_side() {
-    m_zobrist_key ^= Zobrist::side_key;
-}
-
-void Board::update_zobrist_castling() {
-    m_zobrist_key ^= Zobrist::castling_keys[m_castling_rights];
-}
-
-void Board::update_zobrist_ep(Square ep_sq) {
-    if (m_en_passant != NUM_SQUARES)
-        m_zobrist_key ^= Zobrist::ep_keys[m_en_passant];
-    if (ep_sq != NUM_SQUARES)
-        m_zobrist_key ^= Zobrist::ep_keys[ep_sq];
-}
-
-void Board::make_move(const Move& move) {
-    // Save game state for undo
-    // ...
-
-    m_zobrist_key ^= Zobrist::side_key;
-    if (m_en_passant != NUM_SQUARES) 
-        m_zobrist_key ^= Zobrist::ep_keys[m_en_passant];
-    m_zobrist_key ^= Zobrist::castling_keys[m_castling_rights];
-    
-    // Move the piece
-    Piece piece = piece_at(move.from);
-    m_squares[move.from] = Piece::NONE;
-    m_squares[move.to] = piece;
-    
-    // Handle captures
-    // Handle castling
-    // Handle en passant
-    // Handle promotion
-    
-    // Update side to move
-    m_side_to_move = opposite_color(m_side_to_move);
-
-    if (m_en_passant != NUM_SQUARES)  // Changed from new_ep to m_en_passant
-        m_zobrist_key ^= Zobrist::ep_keys[m_en_passant];
-    m_zobrist_key ^= Zobrist::castling_keys[m_castling_rights];
-}
-
-void Board::init_attack_tables() {
-    for (Square sq = A1; sq < NUM_SQUARES; ++sq) {
-        // Pawn attacks
-        pawn_attack_table[WHITE][sq] = 0;
-        pawn_attack_table[BLACK][sq] = 0;
-        
-        int file = file_of(sq);
-        int rank = rank_of(sq);
-        
-        // White pawn attacks
-        if (rank < 7) {
-            if (file > 0) pawn_attack_table[WHITE][sq] |= (1ULL << (sq + 7));
-            if (file < 7) pawn_attack_table[WHITE][sq] |= (1ULL << (sq + 9));
-        }
-        
-        // Black pawn attacks
-        if (rank > 0) {
-            if (file > 0) pawn_attack_table[BLACK][sq] |= (1ULL << (sq - 9));
-            if (file < 7) pawn_attack_table[BLACK][sq] |= (1ULL << (sq - 7));
-        }
-        
-        // Knight attacks
-        uint64_t knight_bb = 0;
-        for (int dx : {-2, -1, 1, 2}) {
-            for (int dy : {-2, -1, 1, 2}) {
-                if (abs(dx) + abs(dy) == 3) {
-                    int file = file_of(sq) + dx;
-                    int rank = rank_of(sq) + dy;
-                    if (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
-                        knight_bb |= 1ULL << (rank * 8 + file);
-                    }
-                }
-            }
-        }
-        knight_attack_table[sq] = knight_bb;
-        
-        // King attacks
-        uint64_t king_bb = 0;
-        for (int dx : {-1, 0, 1}) {
-            for (int dy : {-1, 0, 1}) {
-                if (dx == 0 && dy == 0) continue;
-                int file = file_of(sq) + dx;
-                int rank = rank_of(sq) + dy;
-                if (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
-                    king_bb |= 1ULL << (rank * 8 + file);
-                }
-            }
-        }
-        king_attack_table[sq] = king_bb;
-    }
-}
-
-// Returns bitboard of all attackers to a square
-uint64_t Board::attackers_to(Square sq, Color by_color) const {
-    uint64_t attackers = 0;
-    uint64_t occupied = occupancy();
-    
-    attackers |= pawn_attack_table[opposite_color(by_color)][sq] & m_pieces[by_color][PAWN];
-    attackers |= knight_attack_table[sq] & m_pieces[by_color][KNIGHT];
-    attackers |= get_bishop_attacks(sq, occupied) & (m_pieces[by_color][BISHOP] | m_pieces[by_color][QUEEN]);
-    attackers |= get_rook_attacks(sq, occupied) & (m_pieces[by_color][ROOK] | m_pieces[by_color][QUEEN]);
-    attackers |= king_attack_table[sq] & m_pieces[by_color][KING];
-    
-    return attackers;
-}
-
-// Returns bitboard of squares between two squares (for blocking moves)
-uint64_t Board::squares_between(Square a, Square b) const {
-    const int a_file = file_of(a);
-    const int a_rank = rank_of(a);
-    const int b_file = file_of(b);
-    const int b_rank = rank_of(b);
-    
-    uint64_t result = 0;
-    
-    // Same rank (horizontal)
-    if (a_rank == b_rank) {
-        int start = std::min(a_file, b_file) + 1;
-        int end = std::max(a_file, b_file);
-        for (int f = start; f < end; f++) {
-            result |= 1ULL << (a_rank * 8 + f);
-        }
-    }
-    // Same file (vertical)
-    else if (a_file == b_file) {
-        int start = std::min(a_rank, b_rank) + 1;
-        int end = std::max(a_rank, b_rank);
-        for (int r = start; r < end; r++) {
-            result |= 1ULL << (r * 8 + a_file);
-        }
-    }
-    // Diagonal (same slope)
-    else if (abs(a_file - b_file) == abs(a_rank - b_rank)) {
-        int file_step = (b_file > a_file) ? 1 : -1;
-        int rank_step = (b_rank > a_rank) ? 1 : -1;
-        int f = a_file + file_step;
-        int r = a_rank + rank_step;
-        
-        while (f != b_file && r != b_rank) {
-            result |= 1ULL << (r * 8 + f);
-            f += file_step;
-            r += rank_step;
-        }
-    }
-    
-    return result;
-}
-
-bool Board::is_square_attacked(Square sq, Color by_color) const {
-    Bitboard attackers = 0;
-    
-    // Pawns
-    Bitboard pawn_attacks = pawn_attack_table[by_color][sq];
-    if (pawn_attacks & m_pieces[by_color][PAWN]) return true;
-    
-    // Knights
-    Bitboard knight_attacks = knight_attack_table[sq];
-    if (knight_attacks & m_pieces[by_color][KNIGHT]) return true;
-    
-    // Bishops/Queens
-    Bitboard bishop_attacks = get_bishop_attacks(sq, occupancy());
-    if (bishop_attacks & (m_pieces[by_color][BISHOP] | m_pieces[by_color][QUEEN])) 
-        return true;
-    
-    // Rooks/Queens
-    Bitboard rook_attacks = get_rook_attacks(sq, occupancy());
-    if (rook_attacks & (m_pieces[by_color][ROOK] | m_pieces[by_color][QUEEN])) 
-        return true;
-    
-    // King
-    Bitboard king_attacks = king_attack_table[sq];
-    if (king_attacks & m_pieces[by_color][KING]) return true;
-    
-    return false;
-}
-
-bool Board::is_in_check(Color color) const {
-    Square king_sq = find_king(color);
-    Color opponent = opposite_color(color);
-    return is_square_attacked(king_sq, opponent);
-}
-
-Color Board::opposite_color(Color color) const {
-    return color == WHITE ? BLACK : WHITE;
-}
-
-Square Board::find_king(Color color) const {
-    Bitboard king_bb = m_pieces[color][KING];
-    assert(king_bb != 0 && "No king found for color");
-    return pop_lsb(king_bb);
-}
-
-bool Board::is_checkmate() const {
-    if (!is_in_check(m_side_to_move)) return false;
-    return generate_legal_moves().empty();
-}
-
-bool Board::is_stalemate() const {
-    if (is_in_check(m_side_to_move)) return false;
-    return generate_legal_moves().empty();
-}
-
-bool Board::is_legal(const Move& move) const {
-    // 1. Basic validation
-    if (!is_on_board(move.from) || !is_on_board(move.to)) return false;
-    
-    // 2. Verify piece exists and belongs to current player
-    const Piece& piece = piece_at(move.from);
-    if (piece.color != m_side_to_move) return false;
-
-    // 3. Special cases (en passant, castling, promotion)
-    if (piece.type == PAWN) {
-        // Validate en passant
-        if (move.to == m_en_passant) {
-            //return is_valid_en_passant(move);
-        }
-        // Validate promotion
-        if (move.promotion != NONE_PIECE && 
-            !(rank_of(move.to) == 7 || rank_of(move.to) == 0)) {
-            return false;
-        }
-    }
-    
-    // 4. Simulate the move and check for king safety
-    Board temp = *this;
-    temp.make_move(move);
-    return !temp.is_in_check(m_side_to_move);
-}
-
-std::vector<Move> Board::generate_king_moves(Square sq) const {
-    std::vector<Move> moves;
-    const Piece& king = piece_at(sq);
-    uint64_t attacks = king_attack_table[sq];
-    
-    while (attacks) {
-        Square to = pop_lsb(attacks);
-        const Piece& target = piece_at(to);
-        
-        // Can move to empty squares or capture opponent pieces
-        if (target.type == NONE_PIECE || target.color != king.color) {
-            // Verify destination isn't attacked
-            if (!is_square_attacked(to, opposite_color(king.color))) {
-                moves.push_back({sq, to});
-            }
-        }
-    }
-    
-    // Castling - only if not in check
-    if (!is_in_check(king.color)) {
-        // Kingside castling
-        if ((king.color == WHITE && (m_castling_rights & (1 << WHITE_OO))) ||
-            (king.color == BLACK && (m_castling_rights & (1 << BLACK_OO)))) {
-            Square rook_sq = king.color == WHITE ? H1 : H8;
-            Square f = king.color == WHITE ? F1 : F8;
-            Square g = king.color == WHITE ? G1 : G8;
-            
-            if (is_empty(f) && is_empty(g) &&
-                !is_square_attacked(f, opposite_color(king.color)) &&
-                !is_square_attacked(g, opposite_color(king.color))) {
-                moves.push_back({sq, g});
-            }
-        }
-        
-        // Queenside castling
-        if ((king.color == WHITE && (m_castling_rights & (1 << WHITE_OOO))) ||
-            (king.color == BLACK && (m_castling_rights & (1 << BLACK_OOO)))) {
-            Square rook_sq = king.color == WHITE ? A1 : A8;
-            Square d = king.color == WHITE ? D1 : D8;
-            Square c = king.color == WHITE ? C1 : C8;
-            Square b = king.color == WHITE ? B1 : B8;
-            
-            if (is_empty(d) && is_empty(c) && is_empty(b) &&
-                !is_square_attacked(d, opposite_color(king.color)) &&
-                !is_square_attacked(c, opposite_color(king.color))) {
-                moves.push_back({sq, c});
-            }
-        }
-    }
-    
-    return moves;
-}
-
-// In board.cpp
-std::vector<Move> Board::generate_queen_moves(Square sq) const {
-    std::vector<Move> moves;
-    // Combine rook and bishop attacks for queen
-    uint64_t attacks = get_rook_attacks(sq, occupancy()) | 
-                      get_bishop_attacks(sq, occupancy());
-    
-    while (attacks) {
-        Square to = pop_lsb(attacks);
-        const Piece& target = piece_at(to);
-        if (target.type == NONE_PIECE || target.color != piece_at(sq).color) {
-            moves.push_back({sq, to}); // No promotion for queen moves
-        }
-    }
-    return moves;
-}
-
-// Knight moves
-std::vector<Move> Board::generate_knight_moves(Square sq) const {
-    std::vector<Move> moves;
-    static const int knight_deltas[8] = { -17, -15, -10, -6, 6, 10, 15, 17 };
-    const Piece& knight = piece_at(sq);
-    
-    for (int delta : knight_deltas) {
-        Square to = sq + delta;
-        if (is_on_board(to)) {
-            // Check if move stays on board (no wrapping)
-            int file_diff = abs(file_of(to) - file_of(sq));
-            int rank_diff = abs(rank_of(to) - rank_of(sq));
-            if (file_diff + rank_diff == 3 && file_diff > 0 && rank_diff > 0) {
-                const Piece& target = piece_at(to);
-                if (target.type == NONE_PIECE || target.color != knight.color) {
-                    moves.push_back({sq, to}); // No promotion for knights
-                }
-            }
-        }
-    }
-    return moves;
-}
-
-// Bishop moves
-std::vector<Move> Board::generate_bishop_moves(Square sq) const {
-    std::vector<Move> moves;
-    const Piece& bishop = piece_at(sq);
-    uint64_t attacks = get_bishop_attacks(sq, occupancy());
-    
-    while (attacks) {
-        Square to = pop_lsb(attacks);
-        const Piece& target = piece_at(to);
-        if (target.type == NONE_PIECE || target.color != bishop.color) {
-            moves.push_back({sq, to});
-        }
-    }
-    return moves;
-}
-
-// Rook moves
-std::vector<Move> Board::generate_rook_moves(Square sq) const {
-    std::vector<Move> moves;
-    const Piece& rook = piece_at(sq);
-    uint64_t attacks = get_rook_attacks(sq, occupancy());
-    
-    while (attacks) {
-        Square to = pop_lsb(attacks);
-        const Piece& target = piece_at(to);
-        if (target.type == NONE_PIECE || target.color != rook.color) {
-            moves.push_back({sq, to});
-        }
-    }
-    return moves;
-}
-
-// King moves
-
-std::vector<Move> Board::generate_pawn_moves(Square sq) const {
-    std::vector<Move> moves;
-    const Piece& pawn = piece_at(sq);
-    int direction = (pawn.color == WHITE) ? 1 : -1;
-    Square forward = sq + (8 * direction);
-
-    // Single push
-    if (is_empty(forward)) {
-        // In generate_pawn_moves()
-        // Remove the "promote to P" from non-promotion moves
-        // Only add promotion for 7th->8th rank moves
-        
-        if (rank_of(forward) == 7 || rank_of(forward) == 0) {
-            // Only add promotion moves when actually promoting
-            moves.push_back({sq, forward, QUEEN});
-            moves.push_back({sq, forward, ROOK});
-            moves.push_back({sq, forward, BISHOP});
-            moves.push_back({sq, forward, KNIGHT});
-        } else {
-            moves.push_back({sq, forward}); // Normal move, no promotion
-        }
-        
-        // Double push from starting rank
-        if ((pawn.color == WHITE && Board::rank_of(sq) == 1) ||
-            (pawn.color == BLACK && Board::rank_of(sq) == 6)) {
-            Square double_forward = forward + (8 * direction);
-            if (is_empty(double_forward)) {
-                moves.push_back({sq, double_forward});
-            }
-        }
-    }
-
-    // Captures
-    for (int capture_dir : {-1, 1}) {
-        int new_file = Board::file_of(sq) + capture_dir;
-        if (new_file >= 0 && new_file < 8) {
-            Square capture_sq = forward + capture_dir;
-            if (!is_empty(capture_sq) && piece_at(capture_sq).color != pawn.color) {
-                moves.push_back({sq, capture_sq});
-            }
-            // En passant
-            // In generate_pawn_moves()
-            if (capture_sq == m_en_passant) {
-                moves.push_back({sq, capture_sq});
-            }
-        }
-    }
-
-    return moves;
-}
-
-std::vector<Move> Board::generate_pseudo_legal_moves() const {
-    std::vector<Move> moves;
-    
-    for (Square sq = A1; sq < NUM_SQUARES; ++sq) {
-        const Piece& piece = piece_at(sq);
-        if (piece.color != m_side_to_move) continue;
-        
-        std::vector<Move> piece_moves;
-        
-        switch (piece.type) {
-            case PAWN:
-                piece_moves = generate_pawn_moves(sq);
-                break;
-            case KNIGHT:
-                piece_moves = generate_knight_moves(sq);
-                break;
-            case BISHOP:
-                piece_moves = generate_bishop_moves(sq);
-                break;
-            case ROOK:
-                piece_moves = generate_rook_moves(sq);
-                break;
-            case QUEEN:
-                piece_moves = generate_queen_moves(sq);
-                break;
-            case KING:
-                piece_moves = generate_king_moves(sq);
-                break;
-            default:
-                break;
-        }
-        
-        moves.insert(moves.end(), piece_moves.begin(), piece_moves.end());
-    }
-    
-    return moves;
-}
-
-
-std::vector<Move> Board::generate_legal_moves() const {
-    std::vector<Move> legal_moves;
-    Color us = m_side_to_move;
-    Square king_sq = find_king(us);
-    bool in_check = is_in_check(us);
-    
-    // Get all checking pieces
-    uint64_t checkers = in_check ? attackers_to(king_sq, opposite_color(us)) : 0;
-    
-    // Generate all pseudo-legal moves
-    std::vector<Move> pseudo_legal = generate_pseudo_legal_moves();
-    
-    for (const Move& move : pseudo_legal) {
-        // King moves are special - just check if destination is safe
-        if (piece_at(move.from).type == KING) {
-            if (!is_square_attacked(move.to, opposite_color(us))) {
-                legal_moves.push_back(move);
-            }
-            continue;
-        }
-        
-        // If in check, move must address the check
-        if (in_check) {
-            // Must capture checking piece or block the attack
-            bool valid = false;
-            
-            // Capture the checking piece
-            if (checkers & (1ULL << move.to)) {
-                valid = true;
-            }
-            // Block a sliding attack
-            else if (count_bits(checkers) == 1) {
-                Square checker_sq = pop_lsb(checkers);
-                PieceType checker_type = piece_at(checker_sq).type;
-                if (checker_type == ROOK || checker_type == BISHOP || checker_type == QUEEN) {
-                    uint64_t between = squares_between(king_sq, checker_sq);
-                    if (between & (1ULL << move.to)) {
-                        valid = true;
-                    }
-                }
-            }
-            
-            if (!valid) continue;
-        }
-        
-        // Verify move doesn't leave king in check
-        Board temp = *this;
-        temp.make_move(move);
-        if (!temp.is_in_check(us)) {
-            legal_moves.push_back(move);
-        }
-    }
-    
-    return legal_moves;
-}
-
-PieceType char_to_piece(char c) {
-    switch (toupper(c)) {
-        case 'P': return PAWN;
-        case 'N': return KNIGHT;
-        case 'B': return BISHOP;
-        case 'R': return ROOK;
-        case 'Q': return QUEEN;
-        case 'K': return KING;
-        default: return NONE_PIECE;
-    }
-}
-
-// ===== Debug =====
-void Board::print() const {
-    for (int rank = 7; rank >= 0; --rank) {
-        for (int file = 0; file < 8; ++file) {
-            Square sq = Square(rank * 8 + file);
-            const Piece& p = piece_at(sq);
-            char c = '.';
-            if (p.type != NONE_PIECE) {
-                c = "PNBRQK"[p.type];
-                if (p.color == BLACK) c = tolower(c);
-            }
-            std::cout << c << ' ';
-        }
-        std::cout << '\n';
-    }
-}
-
+// board.cpp
+#include "board.hpp"
+#include "movegen.hpp"
+#include "magic_bits.hpp" // Contains ROOK_MAGIC_NUMBERS, BISHOP_MAGIC_NUMBERS
+#include "polyglot_keys.hpp"
+#include "tt.hpp"
+#include <algorithm>
+#include <sstream>
+#include <cassert>
+#include <cctype>
+#include <iostream>
+#include <bit>
+#include <bitset>
+#include <cmath>
+
+namespace ViperChess {
+
+constexpr Square operator+(Square s, int i) { return Square(int(s) + i); }
+constexpr Square operator-(Square s, int i) { return Square(int(s) - i); }
+Square& operator++(Square& s) { return s = Square(int(s) + 1); }
+Square& operator--(Square& s) { return s = Square(int(s) - 1); }
+Square operator++(Square& s, int) { Square tmp = s; ++s; return tmp; }
+Square operator--(Square& s, int) { Square tmp = s; --s; return tmp; }
+
+// Enum operators for PieceType
+constexpr PieceType operator+(PieceType pt, int i) { return PieceType(int(pt) + i); }
+constexpr PieceType operator-(PieceType pt, int i) { return PieceType(int(pt) - i); }
+PieceType& operator++(PieceType& pt) { return pt = PieceType(int(pt) + 1); }
+PieceType& operator--(PieceType& pt) { return pt = PieceType(int(pt) - 1); }
+PieceType operator++(PieceType& pt, int) { PieceType tmp = pt; ++pt; return tmp; }
+PieceType operator--(PieceType& pt, int) { PieceType tmp = pt; --pt; return tmp; }
+
+// Enum operators for Color
+constexpr Color operator+(Color c, int i) { return Color(int(c) + i); }
+constexpr Color operator-(Color c, int i) { return Color(int(c) - i); }
+Color& operator++(Color& c) { return c = Color(int(c) + 1); }
+Color& operator--(Color& c) { return c = Color(int(c) - 1); }
+Color operator++(Color& c, int) { Color tmp = c; ++c; return tmp; }
+Color operator--(Color& c, int) { Color tmp = c; --c; return tmp; }
+
+// ===== Piece Constants =====
+const Piece Piece::NONE     = {NONE_PIECE, ViperChess::Color::NONE};
+const Piece Piece::W_PAWN   = {PAWN, WHITE};
+const Piece Piece::B_PAWN   = {PAWN, BLACK};
+const Piece Piece::W_KNIGHT = {KNIGHT, WHITE};
+const Piece Piece::B_KNIGHT = {KNIGHT, BLACK};
+const Piece Piece::W_BISHOP = {BISHOP, WHITE};
+const Piece Piece::B_BISHOP = {BISHOP, BLACK};
+const Piece Piece::W_ROOK   = {ROOK, WHITE};
+const Piece Piece::B_ROOK   = {ROOK, BLACK};
+const Piece Piece::W_QUEEN  = {QUEEN, WHITE};
+const Piece Piece::B_QUEEN  = {QUEEN, BLACK};
+const Piece Piece::W_KING   = {KING, WHITE};
+const Piece Piece::B_KING   = {KING, BLACK};
+
+// ===== Magic Bitboard Tables =====
+// Everything below is evaluated by the compiler and lands in read-only data,
+// so there is no startup cost and no initialisation order to get wrong.
+namespace {
+
+constexpr int ROOK_DIRECTIONS[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+constexpr int BISHOP_DIRECTIONS[4][2] = {{1, 1}, {1, -1}, {-1, -1}, {-1, 1}};
+
+// Ray walk from sq, stopping at the first occupied square
+constexpr Bitboard sliding_attacks(int sq, Bitboard occupied, const int (&directions)[4][2]) {
+    Bitboard attacks = 0;
+    for (const auto& d : directions) {
+        for (int file = sq % 8 + d[0], rank = sq / 8 + d[1];
+             file >= 0 && file < 8 && rank >= 0 && rank < 8;
+             file += d[0], rank += d[1]) {
+            Bitboard bb = 1ULL << (rank * 8 + file);
+            attacks |= bb;
+            if (occupied & bb) break;
+        }
+    }
+    return attacks;
+}
+
+// Squares whose occupancy matters: the rays without their last square
+constexpr Bitboard relevant_mask(int sq, const int (&directions)[4][2]) {
+    Bitboard mask = 0;
+    for (const auto& d : directions) {
+        for (int file = sq % 8 + d[0], rank = sq / 8 + d[1];
+             file + d[0] >= 0 && file + d[0] < 8 && rank + d[1] >= 0 && rank + d[1] < 8;
+             file += d[0], rank += d[1]) {
+            mask |= 1ULL << (rank * 8 + file);
+        }
+    }
+    return mask;
+}
+
+struct SliderTables {
+    std::array<Magic, 64> rook;
+    std::array<Magic, 64> bishop;
+    std::array<Bitboard, ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE> attacks;
+};
+
+// Fills one slice per square, rooks first. Subsets of the mask are visited
+// in increasing order (Carry-Rippler), which is exactly the PEXT index.
+// Walking every ray for all ~100k entries would blow the compiler's
+// constexpr budget, so each entry is cut from whole rays at the nearest
+// blocker instead.
+constexpr void fill_slider_table(SliderTables& t, std::array<Magic, 64>& magics,
+                                 const uint64_t* magic_numbers, const int* index_bits,
+                                 const int (&directions)[4][2], uint32_t offset) {
+    Bitboard rays[64][4] = {};
+    for (int sq = 0; sq < 64; ++sq) {
+        for (int d = 0; d < 4; ++d) {
+            for (int file = sq % 8 + directions[d][0], rank = sq / 8 + directions[d][1];
+                 file >= 0 && file < 8 && rank >= 0 && rank < 8;
+                 file += directions[d][0], rank += directions[d][1]) {
+                rays[sq][d] |= 1ULL << (rank * 8 + file);
+            }
+        }
+    }
+
+    for (int sq = 0; sq < 64; ++sq) {
+        Magic& m = magics[sq];
+        m = {relevant_mask(sq, directions), magic_numbers[sq], offset, 64 - index_bits[sq]};
+
+        uint32_t i = 0;
+        Bitboard occ = 0;
+        do {
+#ifdef USE_PEXT
+            uint32_t index = i++;
+#else
+            uint32_t index = uint32_t((occ * m.magic) >> m.shift);
+#endif
+            Bitboard attacks = 0;
+            for (int d = 0; d < 4; ++d) {
+                Bitboard blockers = rays[sq][d] & occ;
+                attacks |= rays[sq][d];
+                if (blockers) {
+                    // Rays towards higher squares meet their lowest blocker first
+                    bool up = directions[d][1] > 0 || (directions[d][1] == 0 && directions[d][0] > 0);
+                    int blocker = up ? std::countr_zero(blockers) : 63 - std::countl_zero(blockers);
+                    attacks &= ~rays[blocker][d];
+                }
+            }
+            t.attacks[offset + index] = attacks;
+            occ = (occ - m.mask) & m.mask;
+        } while (occ);
+
+        offset += 1u << index_bits[sq];
+    }
+}
+
+constexpr SliderTables make_slider_tables() {
+    SliderTables t{};
+    fill_slider_table(t, t.rook, magic_bits::ROOK_MAGIC_NUMBERS, magic_bits::ROOK_INDEX_BITS,
+                      ROOK_DIRECTIONS, 0);
+    fill_slider_table(t, t.bishop, magic_bits::BISHOP_MAGIC_NUMBERS, magic_bits::BISHOP_INDEX_BITS,
+                      BISHOP_DIRECTIONS, ROOK_TABLE_SIZE);
+    return t;
+}
+
+constexpr SliderTables SLIDER_TABLES = make_slider_tables();
+
+// between: squares strictly between a and b; line: the full rank, file or
+// diagonal through both. Zero when a and b are not aligned.
+template <bool Line>
+constexpr std::array<std::array<Bitboard, 64>, 64> make_line_table() {
+    std::array<std::array<Bitboard, 64>, 64> table{};
+    for (int a = 0; a < 64; ++a) {
+        for (int b = 0; b < 64; ++b) {
+            for (const auto* directions : {&ROOK_DIRECTIONS, &BISHOP_DIRECTIONS}) {
+                if (a == b || !(sliding_attacks(a, 0, *directions) & (1ULL << b))) continue;
+                table[a][b] = Line
+                    ? (sliding_attacks(a, 0, *directions) & sliding_attacks(b, 0, *directions))
+                          | (1ULL << a) | (1ULL << b)
+                    : sliding_attacks(a, 1ULL << b, *directions) & sliding_attacks(b, 1ULL << a, *directions);
+            }
+        }
+    }
+    return table;
+}
+
+} // namespace
+
+constinit const std::array<Magic, 64> rook_magics = SLIDER_TABLES.rook;
+constinit const std::array<Magic, 64> bishop_magics = SLIDER_TABLES.bishop;
+constinit const std::array<Bitboard, ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE> slider_attacks = SLIDER_TABLES.attacks;
+constinit const std::array<std::array<Bitboard, 64>, 64> between_table = make_line_table<false>();
+constinit const std::array<std::array<Bitboard, 64>, 64> line_table = make_line_table<true>();
+
+// ===== Board Initialization =====
+Board::Board() : m_side_to_move(WHITE) {
+    m_states.reserve(MAX_GAME_PLY);
+
+    set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+}
+
+Square Board::pop_lsb(uint64_t& bb) 
+{
+        Square sq = Square(__builtin_ctzll(bb));
+        bb &= bb - 1; // Clear the least significant bit
+        return sq;
+}
+
+void Board::set_fen(const std::string& fen) {
+    std::istringstream iss(fen);
+    std::string token;
+    Square sq = A8;
+
+    // Clear the board first
+    m_squares.fill(Piece::NONE);
+    for (auto& color : m_pieces) {
+        for (auto& piece : color) {
+            piece = 0;
+        }
+    }
+    m_by_color = {};
+    m_occupied = 0;
+    m_states.clear();
+    m_castling_rights = 0;  // Reset all castling rights
+    m_en_passant = NUM_SQUARES; // Indicates no en passant
+    m_halfmove_clock = 0;
+    m_plies_from_null = 0;
+    m_fullmove_number = 1;
+
+    // 1. Piece placement
+    iss >> token;
+    for (char c : token) {
+        if (c == '/') {
+            sq = sq - 16; // Move to the beginning of the next rank
+        } else if (isdigit(c)) {
+            sq = sq + (c - '0'); // Skip empty squares
+        } else {
+            Color color = isupper(c) ? WHITE : BLACK;
+            PieceType type = char_to_piece(toupper(c));
+            put_piece({type, color}, sq);
+            ++sq;
+        }
+    }
+
+    // 2. Active color
+    iss >> token;
+    m_side_to_move = (token == "w") ? WHITE : BLACK;
+
+    // 3. Castling availability
+    iss >> token;
+    if (token != "-") {
+        for (char c : token) {
+            switch (c) {
+                case 'K': m_castling_rights |= WHITE_OO; break;
+                case 'Q': m_castling_rights |= WHITE_OOO; break;
+                case 'k': m_castling_rights |= BLACK_OO; break;
+                case 'q': m_castling_rights |= BLACK_OOO; break;
+            }
+        }
+    }
+
+    // 4. En passant target square
+    iss >> token;
+    if (token != "-") {
+        int file = token[0] - 'a';
+        int rank = token[1] - '1';
+        m_en_passant = Square(rank * 8 + file);
+
+        // Like Polyglot, only keep a square some pawn can actually capture on
+        const Color us = m_side_to_move;
+        if (!(pawn_attack_table[opposite_color(us)][m_en_passant] & m_pieces[us][PAWN])) {
+            m_en_passant = NUM_SQUARES;
+        }
+    }
+
+    // 5. Halfmove clock (for 50-move rule)
+    iss >> token;
+    m_halfmove_clock = std::stoi(token);
+
+    // 6. Fullmove number (increments after black's move)
+    if (iss >> token) {
+        m_fullmove_number = std::stoi(token);
+    }
+
+    m_zobrist_key = zobrist_key();
+
+    // The pawn key hashes pawn placement alone. The material key hashes the
+    // piece counts: the key of square n stands for "at least n + 1 pieces of
+    // this kind", so adding or removing one piece is a single XOR.
+    m_pawn_key = 0;
+    m_material_key = 0;
+    for (Color c : {WHITE, BLACK}) {
+        for (Bitboard pawns = m_pieces[c][PAWN]; pawns; ) {
+            m_pawn_key ^= Zobrist::piece_keys[PAWN][c][pop_lsb(pawns)];
+        }
+        for (int pt = PAWN; pt <= KING; ++pt) {
+            for (int n = 0; n < count_bits(m_pieces[c][pt]); ++n) {
+                m_material_key ^= Zobrist::piece_keys[pt][c][n];
+            }
+        }
+    }
+}
+
+namespace Zobrist {
+    using polyglot::RANDOM64;
+
+    constinit const std::array<std::array<std::array<uint64_t, NUM_SQUARES>, NUM_COLORS>, NUM_PIECE_TYPES> piece_keys = [] {
+        std::array<std::array<std::array<uint64_t, NUM_SQUARES>, NUM_COLORS>, NUM_PIECE_TYPES> keys{};
+        for (int pt = PAWN; pt <= KING; ++pt)
+            for (int c = WHITE; c <= BLACK; ++c)
+                for (int sq = 0; sq < 64; ++sq)
+                    keys[pt][c][sq] = RANDOM64[64 * (2 * pt + (c == WHITE)) + sq];
+        return keys;
+    }();
+
+    constinit const uint64_t side_key = RANDOM64[polyglot::TURN_OFFSET];
+
+    constinit const std::array<uint64_t, 16> castling_keys = [] {
+        std::array<uint64_t, 16> keys{};
+        for (int rights = 0; rights < 16; ++rights)
+            for (int bit = 0; bit < 4; ++bit)
+                if (rights & (1 << bit)) keys[rights] ^= RANDOM64[polyglot::CASTLE_OFFSET + bit];
+        return keys;
+    }();
+
+    constinit const std::array<uint64_t, NUM_SQUARES> ep_keys = [] {
+        std::array<uint64_t, NUM_SQUARES> keys{};
+        for (int sq = 0; sq < 64; ++sq) keys[sq] = RANDOM64[polyglot::EP_OFFSET + sq % 8];
+        return keys;
+    }();
+}
+
+namespace {
+
+// Cuckoo hash of every reversible move, keyed by the XOR of the two
+// positions' keys: a knight, bishop, rook, queen or king of either color
+// going from one square to another it attacks on an empty board, and the
+// side to move flipping. The move is stored from the lower square; the same
+// key serves both directions. 3668 moves in 8192 slots, each at one of two.
+constexpr int CUCKOO_SIZE = 8192;
+constexpr int cuckoo_h1(uint64_t key) { return int(key & (CUCKOO_SIZE - 1)); }
+constexpr int cuckoo_h2(uint64_t key) { return int((key >> 16) & (CUCKOO_SIZE - 1)); }
+
+struct CuckooTables {
+    std::array<uint64_t, CUCKOO_SIZE> keys{};
+    std::array<Move, CUCKOO_SIZE> moves{};
+};
+
+constexpr CuckooTables make_cuckoo_tables() {
+    // Zobrist::piece_keys is not a constant expression here, so this reads
+    // the same Polyglot numbers directly
+    auto piece_key = [](int pt, int c, int sq) {
+        return polyglot::RANDOM64[64 * (2 * pt + (c == WHITE)) + sq];
+    };
+    auto attacks = [](int pt, int sq) -> Bitboard {
+        switch (pt) {
+            case KNIGHT: return Board::knight_attack_table[sq];
+            case BISHOP: return sliding_attacks(sq, 0, BISHOP_DIRECTIONS);
+            case ROOK:   return sliding_attacks(sq, 0, ROOK_DIRECTIONS);
+            case QUEEN:  return sliding_attacks(sq, 0, BISHOP_DIRECTIONS) | sliding_attacks(sq, 0, ROOK_DIRECTIONS);
+            default:     return Board::king_attack_table[sq];
+        }
+    };
+
+    CuckooTables tables{};
+    for (auto& move : tables.moves) move = Move::none();
+    int count = 0;
+    for (int pt = KNIGHT; pt <= KING; ++pt) {
+        for (int c = WHITE; c <= BLACK; ++c) {
+            for (int s1 = 0; s1 < 64; ++s1) {
+                for (int s2 = s1 + 1; s2 < 64; ++s2) {
+                    if (!(attacks(pt, s1) & (1ULL << s2))) continue;
+                    Move move(static_cast<Square>(s1), static_cast<Square>(s2));
+                    uint64_t key = piece_key(pt, c, s1) ^ piece_key(pt, c, s2) ^ polyglot::RANDOM64[polyglot::TURN_OFFSET];
+                    // Insert, kicking the occupant to its other slot until
+                    // one comes to rest in an empty one
+                    int slot = cuckoo_h1(key);
+                    while (true) {
+                        std::swap(tables.keys[slot], key);
+                        std::swap(tables.moves[slot], move);
+                        if (move == Move::none()) break;
+                        slot = slot == cuckoo_h1(key) ? cuckoo_h2(key) : cuckoo_h1(key);
+                    }
+                    ++count;
+                }
+            }
+        }
+    }
+    if (count != 3668) throw "cuckoo: unexpected number of reversible moves";
+    return tables;
+}
+
+constinit const CuckooTables CUCKOO = make_cuckoo_tables();
+
+} // namespace
+
+// Key of the current position computed from scratch; make_move keeps
+// m_zobrist_key equal to this incrementally
+uint64_t Board::zobrist_key() const {
+    uint64_t key = 0;
+    for (Square sq = A1; sq < NUM_SQUARES; ++sq) {
+        if (m_squares[sq].type != NONE_PIECE) {
+            key ^= Zobrist::piece_keys[m_squares[sq].type][m_squares[sq].color][sq];
+        }
+    }
+    if (m_side_to_move == WHITE) key ^= Zobrist::side_key;
+    key ^= Zobrist::castling_keys[m_castling_rights];
+    if (m_en_passant != NUM_SQUARES) key ^= Zobrist::ep_keys[m_en_passant];
+    return key;
+}
+
+// Individual piece types
+uint64_t Board::get_kings() const   { return m_pieces[WHITE][KING] | m_pieces[BLACK][KING]; }
+uint64_t Board::get_queens() const  { return m_pieces[WHITE][QUEEN] | m_pieces[BLACK][QUEEN]; }
+uint64_t Board::get_rooks() const   { return m_pieces[WHITE][ROOK] | m_pieces[BLACK][ROOK]; }
+uint64_t Board::get_bishops() const { return m_pieces[WHITE][BISHOP] | m_pieces[BLACK][BISHOP]; }
+uint64_t Board::get_knights() const { return m_pieces[WHITE][KNIGHT] | m_pieces[BLACK][KNIGHT]; }
+uint64_t Board::get_pawns() const   { return m_pieces[WHITE][PAWN] | m_pieces[BLACK][PAWN]; }
+
+// Castling rights for Syzygy
+int Board::get_castling_rights() const {
+    return m_castling_rights;
+}
+
+// ===== Helper Functions =====
+int count_bits(uint64_t b) {
+    return __builtin_popcountll(b);
+}
+
+// Castling rights that survive a move touching each square
+static constexpr std::array<uint8_t, 64> CASTLING_MASK = [] {
+    std::array<uint8_t, 64> mask{};
+    mask.fill(WHITE_OO | WHITE_OOO | BLACK_OO | BLACK_OOO);
+    mask[E1] &= ~(WHITE_OO | WHITE_OOO);
+    mask[A1] &= ~WHITE_OOO;
+    mask[H1] &= ~WHITE_OO;
+    mask[E8] &= ~(BLACK_OO | BLACK_OOO);
+    mask[A8] &= ~BLACK_OOO;
+    mask[H8] &= ~BLACK_OO;
+    return mask;
+}();
+
+void Board::put_piece(Piece piece, Square sq) {
+    const Bitboard bb = 1ULL << sq;
+    m_squares[sq] = piece;
+    m_pieces[piece.color][piece.type] |= bb;
+    m_by_color[piece.color] |= bb;
+    m_occupied |= bb;
+}
+
+void Board::remove_piece(Square sq) {
+    const Bitboard bb = 1ULL << sq;
+    Piece piece = m_squares[sq];
+    m_pieces[piece.color][piece.type] &= ~bb;
+    m_by_color[piece.color] &= ~bb;
+    m_occupied &= ~bb;
+    m_squares[sq] = Piece::NONE;
+}
+
+void Board::move_piece(Square from, Square to) {
+    const Bitboard from_to = (1ULL << from) | (1ULL << to);
+    Piece piece = m_squares[from];
+    m_pieces[piece.color][piece.type] ^= from_to;
+    m_by_color[piece.color] ^= from_to;
+    m_occupied ^= from_to;
+    m_squares[from] = Piece::NONE;
+    m_squares[to] = piece;
+}
+
+void Board::make_move(const Move& move) {
+    const Color us = m_side_to_move;
+    const Square from = move.from();
+    const Square to = move.to();
+    const Piece piece = piece_at(from);
+    const PieceType promotion = move.promotion();
+
+    // En passant: the captured pawn is behind the destination square
+    const Square capture_sq = move.is_en_passant() ? (us == WHITE ? to - 8 : to + 8) : to;
+    const Piece captured = piece_at(capture_sq);
+
+    // Castling: the king moves two files, the rook jumps over it
+    const bool kingside = to > from;
+    const Square rook_from = kingside ? to + 1 : to - 2;
+    const Square rook_to = kingside ? to - 1 : to + 1;
+
+    // Save game state for undo
+    m_states.push_back({m_zobrist_key, m_pawn_key, m_material_key, captured, m_en_passant,
+                        m_castling_rights, static_cast<uint16_t>(m_halfmove_clock),
+                        static_cast<uint16_t>(m_plies_from_null)});
+
+    // Double push: record the skipped square only if an enemy pawn can take
+    // on it, as the Polyglot key does
+    Square new_ep = NUM_SQUARES;
+    if (piece.type == PAWN && abs(int(to) - int(from)) == 16) {
+        Square skipped = Square((int(from) + int(to)) / 2);
+        if (pawn_attack_table[us][skipped] & m_pieces[opposite_color(us)][PAWN]) {
+            new_ep = skipped;
+        }
+    }
+    const uint8_t new_castling = m_castling_rights & CASTLING_MASK[from] & CASTLING_MASK[to];
+
+    // The child's key is known before any piece moves, so its TT bucket is
+    // requested now and arrives while the board is being updated
+    uint64_t key = m_zobrist_key ^ Zobrist::side_key
+                 ^ Zobrist::castling_keys[m_castling_rights] ^ Zobrist::castling_keys[new_castling]
+                 ^ Zobrist::piece_keys[piece.type][us][from]
+                 ^ Zobrist::piece_keys[promotion != NONE_PIECE ? promotion : piece.type][us][to];
+    if (m_en_passant != NUM_SQUARES) key ^= Zobrist::ep_keys[m_en_passant];
+    if (new_ep != NUM_SQUARES) key ^= Zobrist::ep_keys[new_ep];
+    if (captured.type != NONE_PIECE) key ^= Zobrist::piece_keys[captured.type][captured.color][capture_sq];
+    if (move.is_castling()) key ^= Zobrist::piece_keys[ROOK][us][rook_from] ^ Zobrist::piece_keys[ROOK][us][rook_to];
+    TT.prefetch(key);
+    m_zobrist_key = key;
+
+    ++m_halfmove_clock;
+    ++m_plies_from_null;
+
+    // Handle captures
+    if (captured.type != NONE_PIECE) {
+        remove_piece(capture_sq);
+        m_material_key ^= Zobrist::piece_keys[captured.type][captured.color]
+                                             [count_bits(m_pieces[captured.color][captured.type])];
+        if (captured.type == PAWN) {
+            m_pawn_key ^= Zobrist::piece_keys[PAWN][captured.color][capture_sq];
+        }
+        m_halfmove_clock = 0;
+    }
+
+    if (move.is_castling()) {
+        move_piece(rook_from, rook_to);
+    }
+
+    move_piece(from, to);
+
+    if (piece.type == PAWN) {
+        m_halfmove_clock = 0;
+        m_pawn_key ^= Zobrist::piece_keys[PAWN][us][from];
+
+        // Handle promotion
+        if (promotion != NONE_PIECE) {
+            remove_piece(to);
+            put_piece({promotion, us}, to);
+            m_material_key ^= Zobrist::piece_keys[PAWN][us][count_bits(m_pieces[us][PAWN])]
+                            ^ Zobrist::piece_keys[promotion][us][count_bits(m_pieces[us][promotion]) - 1];
+        } else {
+            m_pawn_key ^= Zobrist::piece_keys[PAWN][us][to];
+        }
+    }
+
+    m_castling_rights = new_castling;
+    m_en_passant = new_ep;
+    if (us == BLACK) ++m_fullmove_number;
+    
+    // Update side to move
+    m_side_to_move = opposite_color(us);
+}
+
+void Board::unmake_move(const Move& move) {
+    const StateInfo& state = m_states.back();
+    const Color us = opposite_color(m_side_to_move);
+    const Square from = move.from();
+    const Square to = move.to();
+
+    m_side_to_move = us;
+    if (us == BLACK) --m_fullmove_number;
+
+    if (move.promotion() != NONE_PIECE) {
+        remove_piece(to);
+        put_piece({PAWN, us}, to);
+    }
+
+    move_piece(to, from);
+
+    if (move.is_castling()) {
+        bool kingside = to > from;
+        move_piece(kingside ? to - 1 : to + 1,
+                   kingside ? to + 1 : to - 2);
+    }
+
+    if (state.captured.type != NONE_PIECE) {
+        Square capture_sq = to;
+        if (move.is_en_passant()) {
+            capture_sq = us == WHITE ? to - 8 : to + 8;
+        }
+        put_piece(state.captured, capture_sq);
+    }
+
+    m_zobrist_key = state.zobrist_key;
+    m_pawn_key = state.pawn_key;
+    m_material_key = state.material_key;
+    m_en_passant = state.en_passant;
+    m_castling_rights = state.castling_rights;
+    m_halfmove_clock = state.halfmove_clock;
+    m_plies_from_null = state.plies_from_null;
+    m_states.pop_back();
+}
+
+void Board::make_null_move() {
+    m_states.push_back({m_zobrist_key, m_pawn_key, m_material_key, Piece::NONE, m_en_passant,
+                        m_castling_rights, static_cast<uint16_t>(m_halfmove_clock),
+                        static_cast<uint16_t>(m_plies_from_null)});
+
+    m_zobrist_key ^= Zobrist::side_key;
+    if (m_en_passant != NUM_SQUARES) {
+        m_zobrist_key ^= Zobrist::ep_keys[m_en_passant];
+        m_en_passant = NUM_SQUARES;
+    }
+    ++m_halfmove_clock;
+    m_plies_from_null = 0;
+    m_side_to_move = opposite_color(m_side_to_move);
+}
+
+void Board::unmake_null_move() {
+    const StateInfo& state = m_states.back();
+
+    m_side_to_move = opposite_color(m_side_to_move);
+    m_zobrist_key = state.zobrist_key;
+    m_en_passant = state.en_passant;
+    m_halfmove_clock = state.halfmove_clock;
+    m_plies_from_null = state.plies_from_null;
+    m_states.pop_back();
+}
+
+// Returns bitboard of all attackers to a square
+uint64_t Board::attackers_to(Square sq, Color by_color) const {
+    return attackers_to(sq, by_color, m_occupied);
+}
+
+// Same, with sliders seeing through a caller-supplied occupancy
+uint64_t Board::attackers_to(Square sq, Color by_color, uint64_t occupied) const {
+    uint64_t attackers = 0;
+    
+    attackers |= pawn_attack_table[opposite_color(by_color)][sq] & m_pieces[by_color][PAWN];
+    attackers |= knight_attack_table[sq] & m_pieces[by_color][KNIGHT];
+    attackers |= get_bishop_attacks(sq, occupied) & (m_pieces[by_color][BISHOP] | m_pieces[by_color][QUEEN]);
+    attackers |= get_rook_attacks(sq, occupied) & (m_pieces[by_color][ROOK] | m_pieces[by_color][QUEEN]);
+    attackers |= king_attack_table[sq] & m_pieces[by_color][KING];
+    
+    return attackers;
+}
+
+bool Board::see_ge(const Move& move, int threshold) const {
+    // Castling cannot lose material; promotions are valued as plain moves
+    if (move.is_castling()) return threshold <= 0;
+
+    const Square from = move.from();
+    const Square to = move.to();
+    const PieceType victim = move.is_en_passant() ? PAWN : piece_at(to).type;
+
+    // `swap` is what the side to move stands to gain beyond the threshold.
+    // Winning the victim must cover it, and losing the capturer in return
+    // must not undo it, or the answer is settled without looking further.
+    int swap = piece_value(victim) - threshold;
+    if (swap < 0) return false;
+    swap = piece_value(piece_at(from).type) - swap;
+    if (swap <= 0) return true;
+
+    uint64_t occupied = m_occupied ^ (1ULL << from) ^ (1ULL << to);
+    if (move.is_en_passant()) {
+        occupied ^= 1ULL << (m_side_to_move == WHITE ? to - 8 : to + 8);
+    }
+    uint64_t attackers = attackers_to(to, WHITE, occupied) | attackers_to(to, BLACK, occupied);
+    const uint64_t diagonal = get_bishops() | get_queens();
+    const uint64_t straight = get_rooks() | get_queens();
+
+    Color stm = m_side_to_move;
+    int result = 1;  // 1 while the move's side is ahead of the threshold
+
+    while (true) {
+        stm = opposite_color(stm);
+        attackers &= occupied;
+        const uint64_t stm_attackers = attackers & m_by_color[stm];
+        if (!stm_attackers) break;
+        result ^= 1;
+
+        // Recapture with the least valuable piece; removing it may open a
+        // line for a slider behind it
+        PieceType pt = PAWN;
+        while (!(stm_attackers & m_pieces[stm][pt])) pt = PieceType(pt + 1);
+
+        if (pt == KING) {
+            // The king may only take last, when nothing defends the square
+            return (attackers & m_by_color[opposite_color(stm)]) ? result ^ 1 : result;
+        }
+
+        swap = piece_value(pt) - swap;
+        if (swap < result) break;
+
+        uint64_t lsb = stm_attackers & m_pieces[stm][pt];
+        occupied ^= lsb & -lsb;
+        if (pt == PAWN || pt == BISHOP || pt == QUEEN) {
+            attackers |= get_bishop_attacks(to, occupied) & diagonal;
+        }
+        if (pt == ROOK || pt == QUEEN) {
+            attackers |= get_rook_attacks(to, occupied) & straight;
+        }
+    }
+    return result;
+}
+
+// Pieces giving check to the side to move
+uint64_t Board::checkers() const {
+    return attackers_to(find_king(m_side_to_move), opposite_color(m_side_to_move));
+}
+
+// Pieces of `color` that are the only blocker between their king and an
+// enemy slider
+uint64_t Board::pinned_pieces(Color color) const {
+    const Color them = opposite_color(color);
+    const Square king_sq = find_king(color);
+    const uint64_t occupied = occupancy();
+    const uint64_t queens = m_pieces[them][QUEEN];
+    
+    uint64_t snipers = (get_rook_attacks(king_sq, 0) & (m_pieces[them][ROOK] | queens)) |
+                       (get_bishop_attacks(king_sq, 0) & (m_pieces[them][BISHOP] | queens));
+    uint64_t pinned = 0;
+    
+    while (snipers) {
+        uint64_t blockers = squares_between(king_sq, pop_lsb(snipers)) & occupied;
+        if (blockers && !(blockers & (blockers - 1))) {
+            pinned |= blockers;
+        }
+    }
+    
+    return pinned & m_by_color[color];
+}
+
+bool Board::is_square_attacked(Square sq, Color by_color) const {
+    Bitboard attackers = 0;
+    
+    // Pawns
+    Bitboard pawn_attacks = pawn_attack_table[opposite_color(by_color)][sq];
+    if (pawn_attacks & m_pieces[by_color][PAWN]) return true;
+    
+    // Knights
+    Bitboard knight_attacks = knight_attack_table[sq];
+    if (knight_attacks & m_pieces[by_color][KNIGHT]) return true;
+    
+    // Bishops/Queens
+    Bitboard bishop_attacks = get_bishop_attacks(sq, m_occupied);
+    if (bishop_attacks & (m_pieces[by_color][BISHOP] | m_pieces[by_color][QUEEN])) 
+        return true;
+    
+    // Rooks/Queens
+    Bitboard rook_attacks = get_rook_attacks(sq, m_occupied);
+    if (rook_attacks & (m_pieces[by_color][ROOK] | m_pieces[by_color][QUEEN])) 
+        return true;
+    
+    // King
+    Bitboard king_attacks = king_attack_table[sq];
+    if (king_attacks & m_pieces[by_color][KING]) return true;
+    
+    return false;
+}
+
+bool Board::is_in_check(Color color) const {
+    Square king_sq = find_king(color);
+    Color opponent = opposite_color(color);
+    return is_square_attacked(king_sq, opponent);
+}
+
+Color Board::opposite_color(Color color) const {
+    return color == WHITE ? BLACK : WHITE;
+}
+
+Square Board::find_king(Color color) const {
+    Bitboard king_bb = m_pieces[color][KING];
+    assert(king_bb != 0 && "No king found for color");
+    return pop_lsb(king_bb);
+}
+
+bool Board::is_checkmate() const {
+    if (!is_in_check(m_side_to_move)) return false;
+    MoveList moves;
+    generate_legal_moves(moves);
+    return moves.empty();
+}
+
+bool Board::is_stalemate() const {
+    if (is_in_check(m_side_to_move)) return false;
+    MoveList moves;
+    generate_legal_moves(moves);
+    return moves.empty();
+}
+
+bool Board::is_draw(int ply) const {
+    // Unless the hundredth reversible ply gave mate
+    if (m_halfmove_clock >= 100) {
+        if (!checkers()) return true;
+        MoveList moves;
+        generate_legal_moves(moves);
+        return !moves.empty();
+    }
+
+    // Only positions since the last capture or pawn move can recur, and
+    // only every other ply, with the same side to move
+    const int states = int(m_states.size());
+    const int end = std::min({m_halfmove_clock, m_plies_from_null, states});
+    int earlier = 0;
+    for (int i = 4; i <= end; i += 2) {
+        if (m_states[states - i].zobrist_key == m_zobrist_key) {
+            if (i < ply || ++earlier == 2) return true;
+        }
+    }
+    return false;
+}
+
+bool Board::has_upcoming_repetition(int ply) const {
+    const int states = int(m_states.size());
+    const int end = std::min({m_halfmove_clock, m_plies_from_null, states});
+    if (end < 3) return false;
+
+    // The position i plies back, with the opponent to move, is one move of
+    // ours away only if the opponent's moves since then cancel out; `other`
+    // XORs their move keys together and is zero when they do
+    auto key_back = [&](int i) { return m_states[states - i].zobrist_key; };
+    uint64_t other = m_zobrist_key ^ key_back(1) ^ Zobrist::side_key;
+    for (int i = 3; i <= end; i += 2) {
+        other ^= key_back(i - 1) ^ key_back(i) ^ Zobrist::side_key;
+        if (other != 0) continue;
+
+        const uint64_t move_key = m_zobrist_key ^ key_back(i);
+        int slot = cuckoo_h1(move_key);
+        if (CUCKOO.keys[slot] != move_key) {
+            slot = cuckoo_h2(move_key);
+            if (CUCKOO.keys[slot] != move_key) continue;
+        }
+
+        // Before the root a repetition would need to be the second one;
+        // only the search's own line is cut
+        const Move move = CUCKOO.moves[slot];
+        if (!(between_table[move.from()][move.to()] & m_occupied) && ply > i) return true;
+    }
+    return false;
+}
+
+bool Board::is_pseudo_legal(const Move& move) const {
+    const Color us = m_side_to_move;
+    const Square from = move.from();
+    const Square to = move.to();
+    const Bitboard to_bb = 1ULL << to;
+    const Piece& piece = piece_at(from);
+
+    if (!move.is_valid() || piece.type == NONE_PIECE || piece.color != us) return false;
+    if (m_by_color[us] & to_bb) return false;
+
+    // Rare enough that asking the generator is cheaper than repeating its rules
+    if (move.is_castling()) {
+        if (piece.type != KING) return false;
+        MoveList moves;
+        MoveGen::generate<QUIETS>(*this, moves);
+        return std::find(moves.begin(), moves.end(), move) != moves.end();
+    }
+
+    if (piece.type == PAWN) {
+        const int up = us == WHITE ? 8 : -8;
+        const bool last_rank = rank_of(to) == (us == WHITE ? 7 : 0);
+        if (last_rank != (move.promotion() != NONE_PIECE)) return false;
+        if (move.is_en_passant()) {
+            return to == m_en_passant && (pawn_attack_table[us][from] & to_bb);
+        }
+        if (pawn_attack_table[us][from] & m_by_color[opposite_color(us)] & to_bb) return true;
+        if (!is_empty(to)) return false;
+        if (to == from + up) return true;
+        return to == from + 2 * up && rank_of(from) == (us == WHITE ? 1 : 6) && is_empty(Square(from + up));
+    }
+
+    if (move.promotion() != NONE_PIECE || move.is_en_passant()) return false;
+
+    switch (piece.type) {
+        case KNIGHT: return knight_attack_table[from] & to_bb;
+        case BISHOP: return get_bishop_attacks(from, m_occupied) & to_bb;
+        case ROOK:   return get_rook_attacks(from, m_occupied) & to_bb;
+        case QUEEN:  return get_queen_attacks(from, m_occupied) & to_bb;
+        case KING:   return king_attack_table[from] & to_bb;
+        default:     return false;
+    }
+}
+
+bool Board::is_legal(const Move& move) const {
+    const Square from = move.from();
+    const Square to = move.to();
+
+    // 1. Verify piece exists and belongs to current player
+    const Piece& piece = piece_at(from);
+    if (piece.color != m_side_to_move) return false;
+
+    // 2. Promotions only onto the last rank
+    if (piece.type == PAWN) {
+        if (move.promotion() != NONE_PIECE && 
+            !(rank_of(to) == 7 || rank_of(to) == 0)) {
+            return false;
+        }
+    }
+
+    // 3. Special moves must be made by the right piece
+    if (move.is_castling() && piece.type != KING) return false;
+    if (move.is_en_passant() && (piece.type != PAWN || to != m_en_passant)) return false;
+    
+    // 4. King safety
+    return is_legal(move, pinned_pieces(m_side_to_move), checkers());
+}
+
+bool Board::is_legal(const Move& move, Bitboard pinned, Bitboard checkers) const {
+    const Color us = m_side_to_move;
+    const Color them = opposite_color(us);
+    const Square king_sq = find_king(us);
+    const Square from = move.from();
+    const Square to = move.to();
+    const Bitboard from_bb = 1ULL << from;
+    const Bitboard to_bb = 1ULL << to;
+    const Bitboard occupied = occupancy();
+    
+    if (from == king_sq) {
+        // Castling: the king may not start in, pass through or land in check
+        if (move.is_castling()) {
+            Square transit = Square((int(from) + int(to)) / 2);
+            return !checkers &&
+                   !is_square_attacked(transit, them) &&
+                   !is_square_attacked(to, them);
+        }
+        // Lift the king off the board so sliders see through its square
+        return !attackers_to(to, them, occupied ^ from_bb);
+    }
+    
+    // Double check: only the king can move
+    if (checkers & (checkers - 1)) return false;
+    
+    // En passant removes two pieces from a line at once, so look at the
+    // resulting occupancy directly
+    if (move.is_en_passant()) {
+        Bitboard captured_bb = 1ULL << (us == WHITE ? to - 8 : to + 8);
+        Bitboard after = (occupied ^ from_bb ^ captured_bb) | to_bb;
+        return !(attackers_to(king_sq, them, after) & ~captured_bb);
+    }
+    
+    // Single check: capture the checker or block it
+    if (checkers) {
+        Bitboard checker = checkers;
+        if (!((squares_between(king_sq, pop_lsb(checker)) | checkers) & to_bb)) return false;
+    }
+    
+    // A pinned piece may only move along the line through its king
+    return !(pinned & from_bb) || (line_through(king_sq, from) & to_bb);
+}
+
+// Pseudo-legal moves for the side to move, from the bitboard generator
+void Board::generate_pseudo_legal_moves(MoveList& moves) const {
+    if (is_in_check(m_side_to_move)) {
+        MoveGen::generate<EVASIONS>(*this, moves);
+    } else {
+        MoveGen::generate<NON_EVASIONS>(*this, moves);
+    }
+}
+
+
+void Board::generate_legal_moves(MoveList& legal_moves) const {
+    legal_moves.clear();
+    MoveGen::generate<LEGAL>(*this, legal_moves);
+}
+
+PieceType char_to_piece(char c) {
+    switch (toupper(c)) {
+        case 'P': return PAWN;
+        case 'N': return KNIGHT;
+        case 'B': return BISHOP;
+        case 'R': return ROOK;
+        case 'Q': return QUEEN;
+        case 'K': return KING;
+        default: return NONE_PIECE;
+    }
+}
+
+std::string move_to_uci(const Move& move) {
+    std::string text = {
+        char('a' + Board::file_of(move.from())), char('1' + Board::rank_of(move.from())),
+        char('a' + Board::file_of(move.to())), char('1' + Board::rank_of(move.to()))
+    };
+    if (move.promotion() != NONE_PIECE) {
+        text += "pnbrqk"[move.promotion()];
+    }
+    return text;
+}
+
+// ===== Debug =====
+void Board::print() const {
+    for (int rank = 7; rank >= 0; --rank) {
+        for (int file = 0; file < 8; ++file) {
+            Square sq = Square(rank * 8 + file);
+            const Piece& p = piece_at(sq);
+            char c = '.';
+            if (p.type != NONE_PIECE) {
+                c = "PNBRQK"[p.type];
+                if (p.color == BLACK) c = tolower(c);
+            }
+            std::cout << c << ' ';
+        }
+        std::cout << '\n';
+    }
+}
+
 } // namespace ViperChess
\ No newline at end of file
@@ -1,248 +1,417 @@
-// board.hpp
-#pragma once
-#include <vector>
-#include <string>
-#include <cstdint>
-#include <array>
-#include <random>
-
-namespace ViperChess {
-
-using Bitboard = uint64_t;
-
-// Forward declarations
-enum Color : uint8_t { WHITE, BLACK, NUM_COLORS, NONE };
-enum PieceType : uint8_t { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NUM_PIECE_TYPES, NONE_PIECE };
-enum Square : uint8_t {
-    A1, B1, C1, D1, E1, F1, G1, H1,
-    A2, B2, C2, D2, E2, F2, G2, H2,
-    A3, B3, C3, D3, E3, F3, G3, H3,
-    A4, B4, C4, D4, E4, F4, G4, H4,
-    A5, B5, C5, D5, E5, F5, G5, H5,
-    A6, B6, C6, D6, E6, F6, G6, H6,
-    A7, B7, C7, D7, E7, F7, G7, H7,
-    A8, B8, C8, D8, E8, F8, G8, H8,
-    NUM_SQUARES
-};
-enum castlingRights : uint8_t {
-    WHITE_OO = 1,   // 1 << 0
-    WHITE_OOO = 2,  // 1 << 1
-    BLACK_OO = 4,   // 1 << 2
-    BLACK_OOO = 8   // 1 << 3
-};
-
-// Enum operators
-
-
-struct Move {
-    Square from;
-    Square to;
-    PieceType promotion = NONE_PIECE; // Default to no promotion
-    
-    int weight = 1;
-
-    static Move none() { return Move(NUM_SQUARES, NUM_SQUARES); }
-    
-    // Utility methods
-    bool is_valid() const { return from != NUM_SQUARES && to != NUM_SQUARES; }
-
-    Move() = default;  // Default constructor
-        Move(Square f, Square t, PieceType p = NONE_PIECE) : from(f), to(t), promotion(p) {}
-        
-        // Comparison operator
-        bool operator==(const Move& other) const {
-            return from == other.from && to == other.to && promotion == other.promotion;
-        }
-};
-
-struct Piece {
-    PieceType type;
-    Color color;
-    
-    static const Piece NONE;
-    static const Piece W_PAWN;
-    static const Piece B_PAWN;
-    static const Piece W_KNIGHT;
-    static const Piece B_KNIGHT;
-    static const Piece W_BISHOP;
-    static const Piece B_BISHOP;
-    static const Piece W_ROOK;
-    static const Piece B_ROOK;
-    static const Piece W_QUEEN;
-    static const Piece B_QUEEN;
-    static const Piece W_KING;
-    static const Piece B_KING;
-};
-
-struct Magic {
-    uint64_t mask;
-    uint64_t magic;
-    uint64_t* attacks;
-    int shift;
-};
-
-// Global magic tables
-extern Magic rook_magics[64];
-extern Magic bishop_magics[64];
-extern uint64_t rook_attacks[64][4096];
-extern uint64_t bishop_attacks[64][512];
-
-class Board {
-private:
-    uint64_t m_zobrist_key = 0;
-    std::array<Piece, 64> m_squares;
-    std::array<std::array<Bitboard, NUM_PIECE_TYPES>, NUM_COLORS> m_pieces;
-    Color m_side_to_move;
-    Square m_en_passant;
-    int m_halfmove_clock;
-    int m_fullmove_number;
-    uint8_t m_castling_rights;  // Bitmask for castling rights
-    
-    // Move generation helpers
-    std::vector<Move> generate_pawn_moves(Square sq) const;
-    std::vector<Move> generate_knight_moves(Square sq) const;
-    std::vector<Move> generate_bishop_moves(Square sq) const;
-    std::vector<Move> generate_rook_moves(Square sq) const;
-    std::vector<Move> generate_king_moves(Square sq) const;
-    std::vector<Move> generate_queen_moves(Square sq) const;
-
-    // Magic bitboard helpers
-    void init_magics();
-    static void init_sliding_attacks(Square sq, bool is_rook);
-    static uint64_t compute_rook_attacks(Square sq, uint64_t occupancy);
-    static uint64_t compute_bishop_attacks(Square sq, uint64_t occupancy);
-
-public:
-    uint64_t get_zobrist_key() const { return m_zobrist_key; }
-    void update_zobrist_key(Piece piece, Square sq);
-
-    void update_zobrist_piece(Piece piece, Square sq);
-    void update_zobrist_side();
-    void update_zobrist_castling();
-    void update_zobrist_ep(Square ep_sq);
-    void reset_to_startpos();
-    
-    // Bitboard accessors
-    uint64_t get_pieces(Color c, PieceType pt) const { return m_pieces[c][pt]; }
-    uint64_t get_white_pieces() const;
-    uint64_t get_black_pieces() const;
-    uint64_t get_kings() const;
-    uint64_t get_queens() const;
-    uint64_t get_rooks() const;
-    uint64_t get_bishops() const;
-    uint64_t get_knights() const;
-    uint64_t get_pawns() const;
-    
-    // Board state accessors
-    Square get_ep_square() const { return m_en_passant; }
-    int get_castling_rights() const;
-    int get_fullmove_number() const { return m_fullmove_number; }
-    Board();
-    void set_fen(const std::string& fen);
-    static void init();
-
-    uint64_t occupancy() const {
-        uint64_t occ = 0;
-        for (Color c : {WHITE, BLACK}) {
-            for (PieceType pt : {PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING}) {
-                occ |= m_pieces[c][pt];
-            }
-        }
-        return occ;
-    }
-
-    const std::array<Bitboard, NUM_PIECE_TYPES>& get_pieces(Color color) const { 
-        return m_pieces[color]; 
-    }
-    
-    //Square find_king(Color color) const {
-     //   return static_cast<Square>(__builtin_ctzll(m_pieces[color][KING]));
-    //}
-
-    // Constants - Now properly initialized as std::array
-    static constexpr std::array<Bitboard, 8> FILE_MASKS = {{
-        0x0101010101010101ULL, // File A
-        0x0202020202020202ULL, // File B
-        0x0404040404040404ULL, // File C
-        0x0808080808080808ULL, // File D
-        0x1010101010101010ULL, // File E
-        0x2020202020202020ULL, // File F
-        0x4040404040404040ULL, // File G
-        0x8080808080808080ULL  // File H
-    }};
-    
-    static constexpr std::array<std::array<Bitboard, 64>, 2> KING_SHIELD = {{
-        // White king shields
-        {{
-            (1ULL << A2) | (1ULL << B2) | (1ULL << C2),
-            // ... remaining 63 squares for white
-        }},
-        // Black king shields
-        {{
-            (1ULL << A7) | (1ULL << B7) | (1ULL << C7),
-            // ... remaining 63 squares for black
-        }}
-    }};
-
-    static Square pop_lsb(uint64_t& bb);
-
-    void init_attack_tables();
-
-    uint64_t zobrist_key() const; // Implement Zobrist hashing
-    void make_null_move() { m_side_to_move = opposite_color(m_side_to_move); }
-
-    static uint64_t pawn_attack_table[NUM_COLORS][64];
-    static uint64_t knight_attack_table[64];
-    static uint64_t king_attack_table[64];
-
-    // Accessors
-    const Piece& piece_at(Square sq) const { return m_squares[sq]; }
-    bool is_empty(Square sq) const { return piece_at(sq).type == NONE_PIECE; }
-    bool is_on_board(Square sq) const { return sq >= A1 && sq < NUM_SQUARES; }
-    static int file_of(Square sq) { return sq % 8; }
-    static int rank_of(Square sq) { return sq / 8; }
-
-    // Move generation
-    uint64_t get_rook_attacks(Square sq, uint64_t occupancy) const;
-    uint64_t get_bishop_attacks(Square sq, uint64_t occupancy) const;
-    uint64_t get_queen_attacks(Square sq, uint64_t occupancy) const;
-    std::vector<Move> generate_pseudo_legal_moves() const;
-    std::vector<Move> generate_legal_moves() const;
-    
-    bool is_legal(const Move& move) const;
-
-    // Attack detection
-    Color get_side_to_move() const { return m_side_to_move; }
-    bool is_square_attacked(Square sq, Color by_color) const;
-    Square find_king(Color color) const;
-    bool is_in_check(Color color) const;
-    Color opposite_color(Color color) const;
-    void make_move(const Move& move);
-    bool is_checkmate() const;
-    bool is_stalemate() const;
-
-    uint64_t attackers_to(Square sq, Color by_color) const;
-    uint64_t squares_between(Square a, Square b) const;
-
-    // Debug
-    void print() const;
-};
-
-namespace Zobrist {
-    extern uint64_t piece_keys[NUM_PIECE_TYPES][NUM_COLORS][NUM_SQUARES];
-    extern uint64_t side_key;
-    extern uint64_t castling_keys[16];
-    extern uint64_t ep_keys[NUM_SQUARES];
-    
-    void init();
-}
-
-// Non-member helper functions
-uint64_t rook_mask(Square sq);
-uint64_t bishop_mask(Square sq);
-int count_bits(uint64_t b);
-uint64_t index_to_occupancy(int index, int bits, uint64_t mask);
-PieceType char_to_piece(char c);
-
-
+// board.hpp
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <array>
+#include <random>
+
+// Slider attacks are indexed with BMI2 PEXT when the target has it (the
+// default -march=native build does on BMI2 hosts). Configure with
+// -DVIPERCHESS_PEXT=OFF to force the multiply-shift magic fallback, e.g. on
+// CPUs where PEXT is microcoded.
+#if defined(__BMI2__) && !defined(VIPERCHESS_NO_PEXT)
+#include <immintrin.h>
+#define USE_PEXT
+#endif
+
+namespace ViperChess {
+
+using Bitboard = uint64_t;
+
+// Forward declarations
+enum Color : uint8_t { WHITE, BLACK, NUM_COLORS, NONE };
+enum PieceType : uint8_t { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NUM_PIECE_TYPES, NONE_PIECE };
+enum Square : uint8_t {
+    A1, B1, C1, D1, E1, F1, G1, H1,
+    A2, B2, C2, D2, E2, F2, G2, H2,
+    A3, B3, C3, D3, E3, F3, G3, H3,
+    A4, B4, C4, D4, E4, F4, G4, H4,
+    A5, B5, C5, D5, E5, F5, G5, H5,
+    A6, B6, C6, D6, E6, F6, G6, H6,
+    A7, B7, C7, D7, E7, F7, G7, H7,
+    A8, B8, C8, D8, E8, F8, G8, H8,
+    NUM_SQUARES
+};
+enum castlingRights : uint8_t {
+    WHITE_OO = 1,   // 1 << 0
+    WHITE_OOO = 2,  // 1 << 1
+    BLACK_OO = 4,   // 1 << 2
+    BLACK_OOO = 8   // 1 << 3
+};
+
+// Enum operators
+
+
+// Packed 16-bit move:
+//   bits 0-5    destination square
+//   bits 6-11   origin square
+//   bits 12-14  promotion piece (KNIGHT..QUEEN) or special move kind
+// The square and promotion fields line up with Polyglot book moves and
+// Fathom (Syzygy) moves, so converting between them is a few bit operations.
+class Move {
+public:
+    enum Kind : uint16_t { NORMAL = 0, EN_PASSANT = 5, CASTLING = 6 };
+
+    Move() = default;  // Left uninitialised so MoveList stays trivially constructible
+    constexpr explicit Move(uint16_t data) : m_data(data) {}
+    constexpr Move(Square from, Square to, PieceType promotion = NONE_PIECE)
+        : m_data(uint16_t(to | from << 6 | (promotion == NONE_PIECE ? 0 : promotion << 12))) {}
+
+    static constexpr Move make(Square from, Square to, Kind kind) {
+        return Move(uint16_t(to | from << 6 | kind << 12));
+    }
+
+    static constexpr Move none() { return Move(uint16_t(0)); }
+
+    constexpr Square from() const { return Square((m_data >> 6) & 0x3F); }
+    constexpr Square to() const { return Square(m_data & 0x3F); }
+    constexpr PieceType promotion() const {
+        unsigned p = m_data >> 12 & 7;
+        return p >= KNIGHT && p <= QUEEN ? PieceType(p) : NONE_PIECE;
+    }
+    constexpr bool is_en_passant() const { return (m_data >> 12 & 7) == EN_PASSANT; }
+    constexpr bool is_castling() const { return (m_data >> 12 & 7) == CASTLING; }
+
+    // from/to as a single 12-bit index, for butterfly tables
+    constexpr int from_to() const { return m_data & 0xFFF; }
+    constexpr uint16_t raw() const { return m_data; }
+
+    // Utility methods
+    constexpr bool is_valid() const { return from() != to(); }
+
+    // Polyglot writes castling as king-takes-rook and has no en passant flag
+    constexpr uint16_t to_polyglot() const {
+        if (is_castling()) {
+            Square rook = to() > from() ? Square(to() + 1) : Square(to() - 2);
+            return uint16_t(rook | from() << 6);
+        }
+        return is_en_passant() ? uint16_t(from_to()) : m_data;
+    }
+
+    // Fathom numbers promotions Q=1, R=2, B=3, N=4. Tablebase positions have
+    // no castling rights; en passant is left unflagged for the caller to match.
+    static constexpr Move from_syzygy(unsigned move) {
+        unsigned promotes = move >> 12 & 7;
+        return Move(Square(move >> 6 & 0x3F), Square(move & 0x3F),
+                    promotes ? PieceType(5 - promotes) : NONE_PIECE);
+    }
+
+    constexpr bool operator==(const Move& other) const { return m_data == other.m_data; }
+    constexpr bool operator!=(const Move& other) const { return m_data != other.m_data; }
+
+private:
+    uint16_t m_data;
+};
+
+// Upper bound on the number of legal moves in any reachable position (218),
+// rounded up so pseudo-legal generation can never overflow.
+constexpr int MAX_MOVES = 256;
+
+// Fixed-capacity move container. Lives on the stack, so generating moves at a
+// search node never touches the heap.
+class MoveList {
+public:
+    void push_back(const Move& move) { m_moves[m_size++] = move; }
+    void clear() { m_size = 0; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    Move& operator[](size_t i) { return m_moves[i]; }
+    const Move& operator[](size_t i) const { return m_moves[i]; }
+
+    Move* begin() { return m_moves; }
+    Move* end() { return m_moves + m_size; }
+    const Move* begin() const { return m_moves; }
+    const Move* end() const { return m_moves + m_size; }
+
+private:
+    Move m_moves[MAX_MOVES];
+    size_t m_size = 0;
+};
+
+struct Piece {
+    PieceType type;
+    Color color;
+    
+    static const Piece NONE;
+    static const Piece W_PAWN;
+    static const Piece B_PAWN;
+    static const Piece W_KNIGHT;
+    static const Piece B_KNIGHT;
+    static const Piece W_BISHOP;
+    static const Piece B_BISHOP;
+    static const Piece W_ROOK;
+    static const Piece B_ROOK;
+    static const Piece W_QUEEN;
+    static const Piece B_QUEEN;
+    static const Piece W_KING;
+    static const Piece B_KING;
+};
+
+// Piece values for move ordering and exchange evaluation
+constexpr int piece_value(PieceType pt) {
+    switch(pt) {
+        case PAWN: return 100;
+        case KNIGHT: return 320;
+        case BISHOP: return 330;
+        case ROOK: return 500;
+        case QUEEN: return 900;
+        case KING: return 20000;
+        default: return 0;
+    }
+}
+
+// Irreversible part of the position, pushed by make_move and popped by
+// unmake_move
+struct StateInfo {
+    uint64_t zobrist_key;
+    uint64_t pawn_key;
+    uint64_t material_key;
+    Piece captured;
+    Square en_passant;
+    uint8_t castling_rights;
+    uint16_t halfmove_clock;
+    uint16_t plies_from_null;
+};
+
+// Capacity reserved for the undo stack: game moves plus search plies
+constexpr int MAX_GAME_PLY = 1024;
+
+struct Magic {
+    uint64_t mask;      // Relevant occupancy, board edges excluded
+    uint64_t magic;
+    uint32_t offset;    // Start of this square's slice of slider_attacks
+    int shift;
+
+    unsigned index(uint64_t occupied) const {
+#ifdef USE_PEXT
+        return unsigned(_pext_u64(occupied, mask));
+#else
+        return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+#ifdef USE_PEXT
+constexpr const char* SLIDER_BACKEND = "pext";
+#else
+constexpr const char* SLIDER_BACKEND = "magic";
+#endif
+
+// Each square gets exactly 2^popcount(mask) entries, which both backends
+// index densely: 102400 rook + 5248 bishop entries, about 840 KB.
+constexpr int ROOK_TABLE_SIZE = 0x19000;
+constexpr int BISHOP_TABLE_SIZE = 0x1480;
+
+// Global attack tables, generated at compile time in board.cpp
+extern const std::array<Magic, 64> rook_magics;
+extern const std::array<Magic, 64> bishop_magics;
+extern const std::array<Bitboard, ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE> slider_attacks;
+extern const std::array<std::array<Bitboard, 64>, 64> between_table;  // Squares strictly between two aligned squares
+extern const std::array<std::array<Bitboard, 64>, 64> line_table;     // Whole line through two aligned squares
+
+// ===== Compile-time Table Generation =====
+// Squares reached by one step of each (file, rank) delta that stays on the board
+template <size_t N>
+constexpr std::array<Bitboard, 64> step_attack_table(const int (&deltas)[N][2]) {
+    std::array<Bitboard, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        for (const auto& d : deltas) {
+            int file = sq % 8 + d[0], rank = sq / 8 + d[1];
+            if (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
+                table[sq] |= 1ULL << (rank * 8 + file);
+            }
+        }
+    }
+    return table;
+}
+
+constexpr int KNIGHT_DELTAS[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+constexpr int KING_DELTAS[8][2] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+constexpr int WHITE_PAWN_DELTAS[2][2] = {{-1, 1}, {1, 1}};
+constexpr int BLACK_PAWN_DELTAS[2][2] = {{-1, -1}, {1, -1}};
+
+// Three pawn squares in front of the king, shifted inwards on the edge files
+constexpr std::array<std::array<Bitboard, 64>, 2> king_shield_table() {
+    std::array<std::array<Bitboard, 64>, 2> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        int first_file = sq % 8 == 0 ? 0 : sq % 8 == 7 ? 5 : sq % 8 - 1;
+        int rank = sq / 8;
+        for (int file = first_file; file < first_file + 3; ++file) {
+            if (rank < 7) table[0][sq] |= 1ULL << ((rank + 1) * 8 + file);
+            if (rank > 0) table[1][sq] |= 1ULL << ((rank - 1) * 8 + file);
+        }
+    }
+    return table;
+}
+
+class Board {
+private:
+    uint64_t m_zobrist_key = 0;
+    uint64_t m_pawn_key = 0;      // Pawns of both colors only
+    uint64_t m_material_key = 0;  // Piece counts only, see set_fen
+    std::array<Piece, 64> m_squares;
+    std::array<std::array<Bitboard, NUM_PIECE_TYPES>, NUM_COLORS> m_pieces;
+    std::array<Bitboard, NUM_COLORS> m_by_color;  // Union of m_pieces[c], kept in step by put/remove/move_piece
+    Bitboard m_occupied;                          // m_by_color[WHITE] | m_by_color[BLACK]
+    Color m_side_to_move;
+    Square m_en_passant;
+    int m_halfmove_clock;
+    int m_plies_from_null = 0;  // No repetition reaches back across a null move
+    int m_fullmove_number;
+    uint8_t m_castling_rights;  // Bitmask for castling rights
+    std::vector<StateInfo> m_states; // Undo stack, one entry per made move
+
+    void put_piece(Piece piece, Square sq);
+    void remove_piece(Square sq);
+    void move_piece(Square from, Square to);
+    
+
+public:
+    uint64_t get_zobrist_key() const { return m_zobrist_key; }  // Equals the Polyglot book key
+    uint64_t get_pawn_key() const { return m_pawn_key; }
+    uint64_t get_material_key() const { return m_material_key; }
+
+    // Bitboard accessors
+    uint64_t get_pieces(Color c, PieceType pt) const { return m_pieces[c][pt]; }
+    uint64_t get_white_pieces() const { return m_by_color[WHITE]; }
+    uint64_t get_black_pieces() const { return m_by_color[BLACK]; }
+    uint64_t get_kings() const;
+    uint64_t get_queens() const;
+    uint64_t get_rooks() const;
+    uint64_t get_bishops() const;
+    uint64_t get_knights() const;
+    uint64_t get_pawns() const;
+    
+    // Board state accessors
+    Square get_ep_square() const { return m_en_passant; }
+    int get_castling_rights() const;
+    int get_halfmove_clock() const { return m_halfmove_clock; }
+    int get_fullmove_number() const { return m_fullmove_number; }
+    Board();
+    void set_fen(const std::string& fen);
+
+    uint64_t occupancy() const { return m_occupied; }
+    uint64_t occupancy(Color c) const { return m_by_color[c]; }
+
+    const std::array<Bitboard, NUM_PIECE_TYPES>& get_pieces(Color color) const { 
+        return m_pieces[color]; 
+    }
+    
+    //Square find_king(Color color) const {
+     //   return static_cast<Square>(__builtin_ctzll(m_pieces[color][KING]));
+    //}
+
+    // Constants - Now properly initialized as std::array
+    static constexpr std::array<Bitboard, 8> FILE_MASKS = {{
+        0x0101010101010101ULL, // File A
+        0x0202020202020202ULL, // File B
+        0x0404040404040404ULL, // File C
+        0x0808080808080808ULL, // File D
+        0x1010101010101010ULL, // File E
+        0x2020202020202020ULL, // File F
+        0x4040404040404040ULL, // File G
+        0x8080808080808080ULL  // File H
+    }};
+    
+    static constexpr std::array<std::array<Bitboard, 64>, 2> KING_SHIELD = king_shield_table();
+
+    static Square pop_lsb(uint64_t& bb);
+
+    uint64_t zobrist_key() const; // Implement Zobrist hashing
+    void make_null_move();
+    void unmake_null_move();
+
+    static constexpr std::array<std::array<Bitboard, 64>, NUM_COLORS> pawn_attack_table = {
+        step_attack_table(WHITE_PAWN_DELTAS), step_attack_table(BLACK_PAWN_DELTAS)
+    };
+    static constexpr std::array<Bitboard, 64> knight_attack_table = step_attack_table(KNIGHT_DELTAS);
+    static constexpr std::array<Bitboard, 64> king_attack_table = step_attack_table(KING_DELTAS);
+
+    // Accessors
+    const Piece& piece_at(Square sq) const { return m_squares[sq]; }
+    bool is_empty(Square sq) const { return piece_at(sq).type == NONE_PIECE; }
+    bool is_on_board(Square sq) const { return sq >= A1 && sq < NUM_SQUARES; }
+    static int file_of(Square sq) { return sq % 8; }
+    static int rank_of(Square sq) { return sq / 8; }
+
+    // Move generation
+    uint64_t get_rook_attacks(Square sq, uint64_t occupancy) const {
+        const Magic& m = rook_magics[sq];
+        return slider_attacks[m.offset + m.index(occupancy)];
+    }
+    uint64_t get_bishop_attacks(Square sq, uint64_t occupancy) const {
+        const Magic& m = bishop_magics[sq];
+        return slider_attacks[m.offset + m.index(occupancy)];
+    }
+    uint64_t get_queen_attacks(Square sq, uint64_t occupancy) const {
+        return get_rook_attacks(sq, occupancy) | get_bishop_attacks(sq, occupancy);
+    }
+    void generate_pseudo_legal_moves(MoveList& moves) const;
+    void generate_legal_moves(MoveList& moves) const;
+    
+    // Whether the generator could have produced `move` in this position, for
+    // moves that come from elsewhere (TT, killers) and may not even fit it
+    bool is_pseudo_legal(const Move& move) const;
+
+    // Legality of a pseudo-legal move, decided from pins and checkers
+    // without making the move
+    bool is_legal(const Move& move) const;
+    bool is_legal(const Move& move, Bitboard pinned, Bitboard checkers) const;
+
+    // Attack detection
+    Color get_side_to_move() const { return m_side_to_move; }
+    bool is_square_attacked(Square sq, Color by_color) const;
+    Square find_king(Color color) const;
+    bool is_in_check(Color color) const;
+    Color opposite_color(Color color) const;
+    void make_move(const Move& move);
+    void unmake_move(const Move& move);
+    bool is_checkmate() const;
+    bool is_stalemate() const;
+
+    // Draw by the fifty-move rule, or by repetition. A position repeated
+    // within the last `ply` plies, i.e. inside the search, is a draw the
+    // first time; one from before the root only the second time.
+    bool is_draw(int ply) const;
+    // Whether the side to move has a reversible move back to a position
+    // repeated within the last `ply` plies, so it can hold a draw from here.
+    // Found through the cuckoo tables of reversible moves; the move may be
+    // illegal.
+    bool has_upcoming_repetition(int ply) const;
+
+    uint64_t attackers_to(Square sq, Color by_color) const;
+    uint64_t attackers_to(Square sq, Color by_color, uint64_t occupied) const;
+
+    // Static exchange evaluation: whether `move` wins at least `threshold`
+    // (in piece_value units) once both sides have recaptured on its target
+    // square with their least valuable pieces for as long as it pays. Sliders
+    // behind a capturer join in as it leaves. Pins are ignored.
+    bool see_ge(const Move& move, int threshold = 0) const;
+    uint64_t squares_between(Square a, Square b) const { return between_table[a][b]; }
+    uint64_t line_through(Square a, Square b) const { return line_table[a][b]; }
+    uint64_t checkers() const;
+    uint64_t pinned_pieces(Color color) const;
+
+    // Debug
+    void print() const;
+};
+
+// Hash keys laid out over the Polyglot Random64 array, so the position key
+// can be looked up in .bin opening books directly
+namespace Zobrist {
+    extern const std::array<std::array<std::array<uint64_t, NUM_SQUARES>, NUM_COLORS>, NUM_PIECE_TYPES> piece_keys;
+    extern const uint64_t side_key;                          // XORed in when white is to move
+    extern const std::array<uint64_t, 16> castling_keys;     // Indexed by castling rights mask
+    extern const std::array<uint64_t, NUM_SQUARES> ep_keys;  // Depends on the file only
+}
+
+// Non-member helper functions
+int count_bits(uint64_t b);
+PieceType char_to_piece(char c);
+std::string move_to_uci(const Move& move);  // Long algebraic, e.g. "e2e4", "e7e8q"
+
+
 } // namespace ViperChess
\ No newline at end of file
@@ -1,120 +1,373 @@
-// movegen.cpp
-#include "board.hpp"
-#include <algorithm>
-
-namespace ViperChess {
-
-std::vector<Move> Board::generate_legal_moves() const {
-    std::vector<Move> moves;
-    
-    // Generate for each piece
-    for (Square sq = A1; sq <= H8; ++sq) {
-        if (piece_at(sq).color != m_side_to_move) continue;
-        
-        switch (piece_at(sq).type) {
-            case PAWN: {
-                auto pawn_moves = generate_pawn_moves(sq);
-                moves.insert(moves.end(), pawn_moves.begin(), pawn_moves.end());
-                break;
-            }
-            case KNIGHT: {
-                auto knight_moves = generate_knight_moves(sq);
-                moves.insert(moves.end(), knight_moves.begin(), knight_moves.end());
-                break;
-            }
-            // ... other pieces
-        }
-    }
-    
-    // Remove moves that leave king in check
-    moves.erase(std::remove_if(moves.begin(), moves.end(),
-        [this](const Move& m) {
-            Board temp = *this;
-            temp.make_move(m); // Assume you have make_move implemented
-            return temp.is_king_in_check(m_side_to_move);
-        }), moves.end());
-    
-    return moves;
-}
-
-// Pawn moves (most complex)
-std::vector<Move> Board::generate_pawn_moves(Square sq) const {
-    std::vector<Move> moves;
-    const Color color = piece_at(sq).color;
-    const int forward = (color == WHITE) ? 8 : -8;
-    
-    // Single push
-    Square target = sq + forward;
-    if (is_empty(target)) {
-        add_promotion_moves(moves, sq, target);
-        
-        // Double push from starting rank
-        if ((color == WHITE && rank_of(sq) == 1) || 
-            (color == BLACK && rank_of(sq) == 6)) {
-            Square double_target = target + forward;
-            if (is_empty(double_target)) {
-                moves.push_back({sq, double_target});
-            }
-        }
-    }
-    
-    // Captures
-    for (int capture_dir : {-1, 1}) { // Left and right
-        Square capture_sq = sq + forward + capture_dir;
-        if (is_on_board(capture_sq) && 
-            (piece_at(capture_sq).color == !color || capture_sq == m_en_passant)) {
-            add_promotion_moves(moves, sq, capture_sq);
-        }
-    }
-    
-    return moves;
-}
-
-// Knight moves (fixed pattern)
-std::vector<Move> Board::generate_knight_moves(Square sq) const {
-    static constexpr std::array<int, 8> offsets = {-17, -15, -10, -6, 6, 10, 15, 17};
-    std::vector<Move> moves;
-    
-    for (int offset : offsets) {
-        Square target = sq + offset;
-        if (is_on_board(target) && 
-            piece_at(target).color != m_side_to_move) {
-            moves.push_back({sq, target});
-        }
-    }
-    
-    return moves;
-}
-
-// Sliding pieces (bishops/rooks/queens)
-std::vector<Move> Board::generate_sliding_moves(Square sq) const {
-    static constexpr std::array<std::array<int, 4>, 2> directions = {{
-        {8, -8, 1, -1},  // Rooks
-        {7, -7, 9, -9}    // Bishops
-    }};
-    
-    std::vector<Move> moves;
-    PieceType pt = piece_at(sq).type;
-    int start_idx = (pt == BISHOP) ? 0 : (pt == ROOK) ? 2 : 0; // Queen uses both
-    
-    for (int i = start_idx; i < (pt == QUEEN ? 4 : 2); ++i) {
-        for (Square target = sq + directions[pt == BISHOP ? 1 : 0][i]; 
-             is_on_board(target); 
-             target += directions[pt == BISHOP ? 1 : 0][i]) {
-            
-            if (is_empty(target)) {
-                moves.push_back({sq, target});
-            }
-            else {
-                if (piece_at(target).color != m_side_to_move) {
-                    moves.push_back({sq, target});
-                }
-                break;
-            }
-        }
-    }
-    
-    return moves;
-}
-
-} // namespace ViperChess
\ No newline at end of file
+// movegen.cpp
+#include "movegen.hpp"
+
+namespace ViperChess {
+
+namespace {
+
+constexpr Bitboard RANK_1 = 0xFFULL;
+constexpr Bitboard RANK_2 = RANK_1 << 8;
+constexpr Bitboard RANK_3 = RANK_1 << 16;
+constexpr Bitboard RANK_6 = RANK_1 << 40;
+constexpr Bitboard RANK_7 = RANK_1 << 48;
+constexpr Bitboard FILE_A = Board::FILE_MASKS[0];
+constexpr Bitboard FILE_H = Board::FILE_MASKS[7];
+
+constexpr Bitboard square_bb(Square sq) { return 1ULL << sq; }
+
+// Pawn set shifts, seen from the side that owns the pawns
+template <Color Us>
+constexpr Bitboard shift_up(Bitboard b) { return Us == WHITE ? b << 8 : b >> 8; }
+
+template <Color Us>
+constexpr Bitboard shift_up_west(Bitboard b) { b &= ~FILE_A; return Us == WHITE ? b << 7 : b >> 9; }
+
+template <Color Us>
+constexpr Bitboard shift_up_east(Bitboard b) { b &= ~FILE_H; return Us == WHITE ? b << 9 : b >> 7; }
+
+// Adds one move per target square, the origin being `delta` squares behind it
+void add_shifted_moves(MoveList& moves, Bitboard targets, int delta) {
+    while (targets) {
+        Square to = Board::pop_lsb(targets);
+        moves.push_back({Square(to - delta), to});
+    }
+}
+
+template <GenType Type>
+void add_promotions(MoveList& moves, Square from, Square to, bool capture) {
+    constexpr bool all = Type == EVASIONS || Type == NON_EVASIONS;
+
+    if (all || Type == CAPTURES) {
+        moves.push_back({from, to, QUEEN});
+    }
+    if (all || (Type == CAPTURES && capture) || (Type == QUIETS && !capture)) {
+        moves.push_back({from, to, ROOK});
+        moves.push_back({from, to, BISHOP});
+        moves.push_back({from, to, KNIGHT});
+    }
+}
+
+template <PieceType Pt>
+Bitboard piece_attacks(const Board& board, Square sq, Bitboard occupied) {
+    if constexpr (Pt == KNIGHT) return Board::knight_attack_table[sq];
+    if constexpr (Pt == BISHOP) return board.get_bishop_attacks(sq, occupied);
+    if constexpr (Pt == ROOK)   return board.get_rook_attacks(sq, occupied);
+    if constexpr (Pt == QUEEN)  return board.get_queen_attacks(sq, occupied);
+    return 0;
+}
+
+template <Color Us>
+Bitboard pieces_of(const Board& board) {
+    return board.occupancy(Us);
+}
+
+} // namespace
+
+// Our pieces that are the only blocker between one of our sliders and the
+// enemy king, i.e. pieces whose move may uncover a check.
+template <Color Us>
+Bitboard MoveGen::discovered_check_candidates(const Board& board) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Square ksq = board.find_king(Them);
+    const Bitboard occupied = board.occupancy();
+    const Bitboard queens = board.get_pieces(Us, QUEEN);
+
+    Bitboard snipers = (board.get_rook_attacks(ksq, 0) & (board.get_pieces(Us, ROOK) | queens))
+                     | (board.get_bishop_attacks(ksq, 0) & (board.get_pieces(Us, BISHOP) | queens));
+    Bitboard candidates = 0;
+
+    while (snipers) {
+        Square sniper = Board::pop_lsb(snipers);
+        Bitboard blockers = board.squares_between(ksq, sniper) & occupied;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & pieces_of<Us>(board))) {
+            candidates |= blockers;
+        }
+    }
+    return candidates;
+}
+
+template <Color Us>
+bool MoveGen::gives_discovered_check(const Board& board, Square from, Square to) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Square ksq = board.find_king(Them);
+    const Bitboard occupied = (board.occupancy() ^ square_bb(from)) | square_bb(to);
+    const Bitboard queens = board.get_pieces(Us, QUEEN);
+    const Bitboard rooks = (board.get_pieces(Us, ROOK) | queens) & ~square_bb(from);
+    const Bitboard bishops = (board.get_pieces(Us, BISHOP) | queens) & ~square_bb(from);
+
+    return (board.get_rook_attacks(ksq, occupied) & rooks)
+        || (board.get_bishop_attacks(ksq, occupied) & bishops);
+}
+
+template <Color Us, GenType Type>
+void MoveGen::generate_pawn_moves(const Board& board, MoveList& moves, Bitboard target) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr Bitboard Rank7 = Us == WHITE ? RANK_7 : RANK_2;
+    constexpr Bitboard Rank3 = Us == WHITE ? RANK_3 : RANK_6;
+    constexpr int Up = Us == WHITE ? 8 : -8;
+    constexpr int UpWest = Us == WHITE ? 7 : -9;
+    constexpr int UpEast = Us == WHITE ? 9 : -7;
+
+    const Bitboard empty = ~board.occupancy();
+    const Bitboard enemies = Type == EVASIONS ? pieces_of<Them>(board) & target
+                                              : pieces_of<Them>(board);
+    const Bitboard pawns = board.get_pieces(Us, PAWN);
+    const Bitboard on_7th = pawns & Rank7;
+    const Bitboard not_on_7th = pawns & ~Rank7;
+
+    // Single and double pushes, no promotions
+    if constexpr (Type != CAPTURES) {
+        Bitboard push1 = shift_up<Us>(not_on_7th) & empty;
+        Bitboard push2 = shift_up<Us>(push1 & Rank3) & empty;
+
+        if constexpr (Type == EVASIONS) {
+            push1 &= target;
+            push2 &= target;
+        }
+
+        if constexpr (Type == QUIET_CHECKS) {
+            const Bitboard check_squares = Board::pawn_attack_table[Them][board.find_king(Them)];
+            const Bitboard dc = discovered_check_candidates<Us>(board) & not_on_7th;
+
+            for (int delta : {Up, Up + Up}) {
+                Bitboard targets = (delta == Up ? push1 : push2)
+                                 & (check_squares | (delta == Up ? shift_up<Us>(dc) : shift_up<Us>(shift_up<Us>(dc))));
+                while (targets) {
+                    Square to = Board::pop_lsb(targets);
+                    Square from = Square(to - delta);
+                    if ((check_squares & square_bb(to)) || gives_discovered_check<Us>(board, from, to)) {
+                        moves.push_back({from, to});
+                    }
+                }
+            }
+        } else {
+            add_shifted_moves(moves, push1, Up);
+            add_shifted_moves(moves, push2, Up + Up);
+        }
+    }
+
+    // Promotions, split between CAPTURES and QUIETS by add_promotions
+    if constexpr (Type != QUIET_CHECKS) {
+        if (on_7th) {
+            Bitboard west = shift_up_west<Us>(on_7th) & enemies;
+            Bitboard east = shift_up_east<Us>(on_7th) & enemies;
+            Bitboard push = shift_up<Us>(on_7th) & empty;
+
+            if constexpr (Type == EVASIONS) {
+                push &= target;
+            }
+
+            while (west) {
+                Square to = Board::pop_lsb(west);
+                add_promotions<Type>(moves, Square(to - UpWest), to, true);
+            }
+            while (east) {
+                Square to = Board::pop_lsb(east);
+                add_promotions<Type>(moves, Square(to - UpEast), to, true);
+            }
+            while (push) {
+                Square to = Board::pop_lsb(push);
+                add_promotions<Type>(moves, Square(to - Up), to, false);
+            }
+        }
+    }
+
+    // Captures and en passant
+    if constexpr (Type == CAPTURES || Type == EVASIONS || Type == NON_EVASIONS) {
+        add_shifted_moves(moves, shift_up_west<Us>(not_on_7th) & enemies, UpWest);
+        add_shifted_moves(moves, shift_up_east<Us>(not_on_7th) & enemies, UpEast);
+
+        const Square ep = board.get_ep_square();
+        if (ep != NUM_SQUARES) {
+            // When evading, en passant must remove the checker or land on the blocking square
+            if (Type != EVASIONS || (target & (square_bb(Square(ep - Up)) | square_bb(ep)))) {
+                Bitboard attackers = not_on_7th & Board::pawn_attack_table[Them][ep];
+                while (attackers) {
+                    moves.push_back(Move::make(Board::pop_lsb(attackers), ep, Move::EN_PASSANT));
+                }
+            }
+        }
+    }
+}
+
+template <Color Us, PieceType Pt, GenType Type>
+void MoveGen::generate_piece_moves(const Board& board, MoveList& moves, Bitboard target) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Bitboard occupied = board.occupancy();
+    Bitboard pieces = board.get_pieces(Us, Pt);
+
+    Bitboard check_squares = 0;
+    Bitboard dc = 0;
+    if constexpr (Type == QUIET_CHECKS) {
+        check_squares = piece_attacks<Pt>(board, board.find_king(Them), occupied);
+        dc = discovered_check_candidates<Us>(board);
+    }
+
+    while (pieces) {
+        Square from = Board::pop_lsb(pieces);
+        Bitboard attacks = piece_attacks<Pt>(board, from, occupied) & target;
+
+        if constexpr (Type == QUIET_CHECKS) {
+            if (!(dc & square_bb(from))) {
+                attacks &= check_squares;
+            }
+        }
+
+        while (attacks) {
+            Square to = Board::pop_lsb(attacks);
+            if constexpr (Type == QUIET_CHECKS) {
+                if (!(check_squares & square_bb(to)) && !gives_discovered_check<Us>(board, from, to)) {
+                    continue;
+                }
+            }
+            moves.push_back({from, to});
+        }
+    }
+}
+
+template <Color Us, GenType Type>
+void MoveGen::generate_king_moves(const Board& board, MoveList& moves, Bitboard target) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Square ksq = board.find_king(Us);
+    Bitboard attacks = Board::king_attack_table[ksq] & target;
+
+    if constexpr (Type == QUIET_CHECKS) {
+        // A king can only give check by uncovering one
+        if (!(discovered_check_candidates<Us>(board) & square_bb(ksq))) {
+            return;
+        }
+    }
+
+    while (attacks) {
+        Square to = Board::pop_lsb(attacks);
+        if constexpr (Type == QUIET_CHECKS) {
+            if (!gives_discovered_check<Us>(board, ksq, to)) continue;
+        }
+        moves.push_back({ksq, to});
+    }
+
+    // Castling: path must be empty and the king may not pass through check
+    if constexpr (Type == QUIETS || Type == NON_EVASIONS) {
+        constexpr int OO = Us == WHITE ? WHITE_OO : BLACK_OO;
+        constexpr int OOO = Us == WHITE ? WHITE_OOO : BLACK_OOO;
+        const int rights = board.get_castling_rights();
+
+        if ((rights & (OO | OOO)) && !board.is_square_attacked(ksq, Them)) {
+            const Bitboard occupied = board.occupancy();
+
+            if (rights & OO) {
+                constexpr Square f = Us == WHITE ? F1 : F8;
+                constexpr Square g = Us == WHITE ? G1 : G8;
+                if (!(occupied & (square_bb(f) | square_bb(g))) &&
+                    !board.is_square_attacked(f, Them) &&
+                    !board.is_square_attacked(g, Them)) {
+                    moves.push_back(Move::make(ksq, g, Move::CASTLING));
+                }
+            }
+
+            if (rights & OOO) {
+                constexpr Square d = Us == WHITE ? D1 : D8;
+                constexpr Square c = Us == WHITE ? C1 : C8;
+                constexpr Square b = Us == WHITE ? B1 : B8;
+                if (!(occupied & (square_bb(d) | square_bb(c) | square_bb(b))) &&
+                    !board.is_square_attacked(d, Them) &&
+                    !board.is_square_attacked(c, Them)) {
+                    moves.push_back(Move::make(ksq, c, Move::CASTLING));
+                }
+            }
+        }
+    }
+}
+
+template <Color Us, GenType Type>
+void MoveGen::generate(const Board& board, MoveList& moves) {
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    const Bitboard us = pieces_of<Us>(board);
+
+    Bitboard target;
+    Bitboard king_target;
+
+    if constexpr (Type == EVASIONS) {
+        const Square ksq = board.find_king(Us);
+        Bitboard checkers = board.attackers_to(ksq, Them);
+        king_target = ~us;
+        target = ~us;
+
+        if (checkers) {
+            // Double check: only the king can move
+            if (checkers & (checkers - 1)) {
+                generate_king_moves<Us, Type>(board, moves, king_target);
+                return;
+            }
+            // Single check: capture the checker or block it
+            target = board.squares_between(ksq, Board::pop_lsb(checkers)) | board.attackers_to(ksq, Them);
+        }
+    } else {
+        if constexpr (Type == CAPTURES) target = pieces_of<Them>(board);
+        if constexpr (Type == QUIETS || Type == QUIET_CHECKS) target = ~board.occupancy();
+        if constexpr (Type == NON_EVASIONS) target = ~us;
+        king_target = target;
+    }
+
+    generate_pawn_moves<Us, Type>(board, moves, target);
+    generate_piece_moves<Us, KNIGHT, Type>(board, moves, target);
+    generate_piece_moves<Us, BISHOP, Type>(board, moves, target);
+    generate_piece_moves<Us, ROOK, Type>(board, moves, target);
+    generate_piece_moves<Us, QUEEN, Type>(board, moves, target);
+    generate_king_moves<Us, Type>(board, moves, king_target);
+}
+
+template <GenType Type>
+void MoveGen::generate(const Board& board, MoveList& moves) {
+    if (board.get_side_to_move() == WHITE) {
+        generate<WHITE, Type>(board, moves);
+    } else {
+        generate<BLACK, Type>(board, moves);
+    }
+}
+
+// Legal moves: evasions or non-evasions, then a pin/check-mask filter. The
+// evasion generator already restricts non-king moves to the check mask, so
+// only pinned pieces, king moves and en passant need a closer look.
+template <>
+void MoveGen::generate<LEGAL>(const Board& board, MoveList& moves) {
+    const Color us = board.get_side_to_move();
+    const Square ksq = board.find_king(us);
+    const Bitboard checkers = board.checkers();
+    const Bitboard pinned = board.pinned_pieces(us);
+
+    MoveList pseudo_legal;
+    if (checkers) {
+        generate<EVASIONS>(board, pseudo_legal);
+    } else {
+        generate<NON_EVASIONS>(board, pseudo_legal);
+    }
+
+    for (const Move& move : pseudo_legal) {
+        bool needs_check = (pinned & square_bb(move.from())) || move.from() == ksq ||
+                           move.is_en_passant();
+        if (!needs_check || board.is_legal(move, pinned, checkers)) {
+            moves.push_back(move);
+        }
+    }
+}
+
+// Explicit instantiations
+template void MoveGen::generate<CAPTURES>(const Board&, MoveList&);
+template void MoveGen::generate<QUIETS>(const Board&, MoveList&);
+template void MoveGen::generate<QUIET_CHECKS>(const Board&, MoveList&);
+template void MoveGen::generate<EVASIONS>(const Board&, MoveList&);
+template void MoveGen::generate<NON_EVASIONS>(const Board&, MoveList&);
+
+template void MoveGen::generate<WHITE, CAPTURES>(const Board&, MoveList&);
+template void MoveGen::generate<WHITE, QUIETS>(const Board&, MoveList&);
+template void MoveGen::generate<WHITE, QUIET_CHECKS>(const Board&, MoveList&);
+template void MoveGen::generate<WHITE, EVASIONS>(const Board&, MoveList&);
+template void MoveGen::generate<WHITE, NON_EVASIONS>(const Board&, MoveList&);
+template void MoveGen::generate<BLACK, CAPTURES>(const Board&, MoveList&);
+template void MoveGen::generate<BLACK, QUIETS>(const Board&, MoveList&);
+template void MoveGen::generate<BLACK, QUIET_CHECKS>(const Board&, MoveList&);
+template void MoveGen::generate<BLACK, EVASIONS>(const Board&, MoveList&);
+template void MoveGen::generate<BLACK, NON_EVASIONS>(const Board&, MoveList&);
+
+} // namespace ViperChess
@@ -1,10 +1,47 @@
-// movegen.hpp
-#pragma once
-#include "board.hpp"
-
-class MoveGen {
-public:
-    // static void generate_pawn_moves(const Board& board, std::vector<Move>& moves);
-    // static void generate_king_moves(Square sq, Bitboard allies, Bitboard enemies, std::vector<Move>& moves);
-    // ... other pieces
-};
\ No newline at end of file
+// movegen.hpp
+#pragma once
+#include "board.hpp"
+
+namespace ViperChess {
+
+// What a call to MoveGen::generate produces. All output is pseudo-legal:
+// moves may still leave the mover's own king in check.
+enum GenType {
+    CAPTURES,      // Captures (including en passant and capture-promotions) and quiet queen promotions
+    QUIETS,        // Non-captures, castling and quiet under-promotions
+    QUIET_CHECKS,  // Non-captures that give direct or discovered check (no promotions, no castling)
+    EVASIONS,      // Every move that may get the side to move out of check
+    NON_EVASIONS,  // CAPTURES + QUIETS, for positions that are not in check
+    LEGAL          // Every legal move
+};
+
+class MoveGen {
+public:
+    // Appends moves of the given type for the side to move.
+    template <GenType Type>
+    static void generate(const Board& board, MoveList& moves);
+
+    template <Color Us, GenType Type>
+    static void generate(const Board& board, MoveList& moves);
+
+private:
+    template <Color Us, GenType Type>
+    static void generate_pawn_moves(const Board& board, MoveList& moves, Bitboard target);
+
+    template <Color Us, PieceType Pt, GenType Type>
+    static void generate_piece_moves(const Board& board, MoveList& moves, Bitboard target);
+
+    template <Color Us, GenType Type>
+    static void generate_king_moves(const Board& board, MoveList& moves, Bitboard target);
+
+    template <Color Us>
+    static Bitboard discovered_check_candidates(const Board& board);
+
+    template <Color Us>
+    static bool gives_discovered_check(const Board& board, Square from, Square to);
+};
+
+template <>
+void MoveGen::generate<LEGAL>(const Board& board, MoveList& moves);
+
+} // namespace ViperChess
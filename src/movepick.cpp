@@ -0,0 +1,203 @@
+// movepick.cpp
+#include "movepick.hpp"
+#include "movegen.hpp"
+#include <utility>
+
+namespace ViperChess {
+
+namespace {
+
+// Bishop for knight loses 10 on piece values but is an even trade
+constexpr int GOOD_CAPTURE_THRESHOLD = -20;
+
+// Capture history at full strength is worth about two pawns of victim value
+constexpr int CAPTURE_HISTORY_DIVISOR = 8;
+
+} // namespace
+
+MovePicker::MovePicker(const Board& board, Move tt_move, const Move* killers, Move counter_move,
+                       const ButterflyHistory& history, const CaptureHistory& capture_history,
+                       const PieceToHistory* const* continuation)
+    : m_board(board),
+      m_history(&history),
+      m_capture_history(&capture_history),
+      m_continuation{continuation[0], continuation[1]},
+      m_tt_move(tt_move),
+      m_killers{killers[0], killers[1]},
+      m_counter_move(counter_move)
+{
+    m_stage = board.is_in_check(board.get_side_to_move()) ? EVASION_TT : MAIN_TT;
+    if (!tt_move.is_valid() || !board.is_pseudo_legal(tt_move)) {
+        m_tt_move = Move::none();
+        ++m_stage;
+    }
+}
+
+MovePicker::MovePicker(const Board& board, const CaptureHistory& capture_history)
+    : m_board(board),
+      m_capture_history(&capture_history),
+      m_stage(QCAPTURE_INIT)
+{
+}
+
+bool MovePicker::is_capture_stage(Move move) const {
+    return !m_board.is_empty(move.to()) || move.is_en_passant() || move.promotion() == QUEEN;
+}
+
+bool MovePicker::is_valid_quiet(Move move) const {
+    return move.is_valid() && move != m_tt_move && !is_capture_stage(move)
+        && m_board.is_pseudo_legal(move);
+}
+
+// Most valuable victim first, then capture history, then least valuable
+// attacker; a promotion counts as capturing the piece it becomes
+void MovePicker::score_captures(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const Move move = m_moves[i];
+        const Piece attacker = m_board.piece_at(move.from());
+        const PieceType victim = move.is_en_passant() ? PAWN : m_board.piece_at(move.to()).type;
+        m_scores[i] = 8 * (piece_value(victim) + piece_value(move.promotion()))
+                    + (*m_capture_history)[piece_index(attacker)][move.to()][victim] / CAPTURE_HISTORY_DIVISOR
+                    - int(attacker.type);
+    }
+}
+
+int MovePicker::quiet_score(Move move) const {
+    const int piece = piece_index(m_board.piece_at(move.from()));
+    int score = (*m_history)[m_board.get_side_to_move()][move.from_to()];
+    for (const PieceToHistory* continuation : m_continuation) {
+        if (continuation) score += (*continuation)[piece][move.to()];
+    }
+    return score;
+}
+
+void MovePicker::score_quiets(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        m_scores[i] = quiet_score(m_moves[i]);
+    }
+}
+
+Move MovePicker::pick_best() {
+    size_t best = m_cur;
+    for (size_t i = m_cur + 1; i < m_end; ++i) {
+        if (m_scores[i] > m_scores[best]) best = i;
+    }
+    std::swap(m_moves[m_cur], m_moves[best]);
+    std::swap(m_scores[m_cur], m_scores[best]);
+    return m_moves[m_cur++];
+}
+
+Move MovePicker::next_move() {
+    while (true) {
+        switch (m_stage) {
+        case MAIN_TT:
+        case EVASION_TT:
+            ++m_stage;
+            return m_tt_move;
+
+        case CAPTURE_INIT:
+        case QCAPTURE_INIT:
+            MoveGen::generate<CAPTURES>(m_board, m_moves);
+            m_end = m_moves.size();
+            score_captures(0, m_end);
+            ++m_stage;
+            break;
+
+        case GOOD_CAPTURE:
+            while (m_cur < m_end) {
+                const Move move = pick_best();
+                if (move == m_tt_move) continue;
+
+                // Captures that lose material once the exchange on the target
+                // square plays out wait until after the quiets
+                if (!m_board.see_ge(move, GOOD_CAPTURE_THRESHOLD)) {
+                    std::swap(m_moves[m_cur - 1], m_moves[m_bad_end]);
+                    std::swap(m_scores[m_cur - 1], m_scores[m_bad_end]);
+                    ++m_bad_end;
+                    continue;
+                }
+                return move;
+            }
+            ++m_stage;
+            break;
+
+        case KILLER_1:
+        case KILLER_2: {
+            const Move killer = m_killers[m_stage - KILLER_1];
+            ++m_stage;
+            if (is_valid_quiet(killer)) return killer;
+            break;
+        }
+
+        case COUNTER_MOVE:
+            ++m_stage;
+            if (m_counter_move != m_killers[0] && m_counter_move != m_killers[1]
+                && is_valid_quiet(m_counter_move)) {
+                return m_counter_move;
+            }
+            m_counter_move = Move::none();  // Not handed out, so not skipped later
+            break;
+
+        case QUIET_INIT:
+            m_cur = m_moves.size();
+            MoveGen::generate<QUIETS>(m_board, m_moves);
+            m_end = m_moves.size();
+            score_quiets(m_cur, m_end);
+            ++m_stage;
+            break;
+
+        case QUIET:
+            while (m_cur < m_end) {
+                const Move move = pick_best();
+                if (move != m_tt_move && move != m_killers[0] && move != m_killers[1]
+                    && move != m_counter_move) {
+                    return move;
+                }
+            }
+            m_cur = 0;
+            m_end = m_bad_end;
+            ++m_stage;
+            break;
+
+        case BAD_CAPTURE:
+            // Already in picking order
+            while (m_cur < m_end) {
+                const Move move = m_moves[m_cur++];
+                if (move != m_tt_move) return move;
+            }
+            m_stage = DONE;
+            break;
+
+        case EVASION_INIT: {
+            MoveGen::generate<EVASIONS>(m_board, m_moves);
+            m_end = m_moves.size();
+            // Captures of the checker first, then quiet moves by history
+            for (size_t i = 0; i < m_end; ++i) {
+                const Move move = m_moves[i];
+                if (is_capture_stage(move)) {
+                    score_captures(i, i + 1);
+                    m_scores[i] += 1 << 24;
+                } else {
+                    m_scores[i] = quiet_score(move);
+                }
+            }
+            ++m_stage;
+            break;
+        }
+
+        case EVASION:
+        case QCAPTURE:
+            while (m_cur < m_end) {
+                const Move move = pick_best();
+                if (move != m_tt_move) return move;
+            }
+            m_stage = DONE;
+            break;
+
+        case DONE:
+            return Move::none();
+        }
+    }
+}
+
+} // namespace ViperChess
@@ -0,0 +1,94 @@
+// movepick.hpp
+#pragma once
+#include "board.hpp"
+
+namespace ViperChess {
+
+// Pieces as history indices: color * NUM_PIECE_TYPES + type
+constexpr int NUM_PIECE_INDICES = int(NUM_COLORS) * int(NUM_PIECE_TYPES);
+constexpr int piece_index(Piece piece) { return int(piece.color) * int(NUM_PIECE_TYPES) + int(piece.type); }
+
+// Move ordering statistics, read by the picker and written by the search on
+// cutoffs. All of them stay within +-HISTORY_MAX.
+constexpr int HISTORY_MAX = 16384;
+
+// Quiet move history, [color][from_to]
+using ButterflyHistory = int[NUM_COLORS][64 * 64];
+// Quiet move history, [moving piece][to]. The continuation history holds one
+// of these per (piece, destination) of an earlier move in the line, so a
+// move is scored by how it has fared as a reply to that move.
+using PieceToHistory = int16_t[NUM_PIECE_INDICES][64];
+// Capture history, [moving piece][to][captured type]; the captured type is
+// NONE_PIECE for a promotion that captures nothing
+using CaptureHistory = int16_t[NUM_PIECE_INDICES][64][NONE_PIECE + 1];
+
+// Hands out the moves of a node one at a time, best first, generating each
+// kind only when the previous stages are used up. A node that cuts off on
+// the TT move never generates at all, and one that cuts off on a capture
+// never generates quiets. Moves are scored once per stage and picked by
+// selection, so the unsearched tail is never sorted.
+//
+// Moves are pseudo-legal; the caller checks legality. Stage order:
+//   main search:   TT move, good captures, killers, counter-move, quiets by
+//                  history, bad captures (those losing material by SEE)
+//   in check:      TT move, evasions (captures first, then by history)
+//   quiescence:    captures, most valuable victim first
+// Captures go by victim value, then capture history; quiets by the sum of
+// the butterfly history and the continuation histories of the last two
+// moves.
+class MovePicker {
+public:
+    // Main search. `killers` has two slots; `counter_move` answers the
+    // opponent's last move and may be none. `continuation` holds the tables
+    // of the opponent's last move and of our own move before it, either of
+    // which is null after a null move or near the root.
+    MovePicker(const Board& board, Move tt_move, const Move* killers, Move counter_move,
+               const ButterflyHistory& history, const CaptureHistory& capture_history,
+               const PieceToHistory* const* continuation);
+
+    // Quiescence search: captures only
+    MovePicker(const Board& board, const CaptureHistory& capture_history);
+
+    // Move::none() once every stage is done
+    Move next_move();
+
+private:
+    enum Stage {
+        MAIN_TT, CAPTURE_INIT, GOOD_CAPTURE, KILLER_1, KILLER_2, COUNTER_MOVE,
+        QUIET_INIT, QUIET, BAD_CAPTURE,
+        EVASION_TT, EVASION_INIT, EVASION,
+        QCAPTURE_INIT, QCAPTURE,
+        DONE
+    };
+
+    // Moves that CAPTURES generates: captures, en passant, queen promotions
+    bool is_capture_stage(Move move) const;
+    // Some quiet stage may hand out this move; it is not pseudo-legal-checked
+    bool is_valid_quiet(Move move) const;
+
+    void score_captures(size_t begin, size_t end);
+    void score_quiets(size_t begin, size_t end);
+    int quiet_score(Move move) const;
+    // Swaps the best of [m_cur, m_end) to m_cur and returns it
+    Move pick_best();
+
+    const Board& m_board;
+    const ButterflyHistory* m_history = nullptr;
+    const CaptureHistory* m_capture_history;
+    const PieceToHistory* m_continuation[2] = {nullptr, nullptr};
+    Move m_tt_move = Move::none();
+    Move m_killers[2] = {Move::none(), Move::none()};
+    Move m_counter_move = Move::none();
+    int m_stage;
+
+    // Captures go first in m_moves. Bad ones are swapped down into
+    // [0, m_bad_end) as they are met and tried after the quiets, which are
+    // generated behind the captures.
+    MoveList m_moves;
+    int m_scores[MAX_MOVES];
+    size_t m_cur = 0;
+    size_t m_end = 0;
+    size_t m_bad_end = 0;
+};
+
+} // namespace ViperChess
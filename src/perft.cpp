@@ -0,0 +1,116 @@
+// perft.cpp
+#include "perft.hpp"
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <thread>
+
+namespace ViperChess {
+
+PerftHash::PerftHash(size_t mb_size) {
+    // Round down to a power of two so the index is a mask
+    size_t count = std::max<size_t>(1, mb_size * 1024 * 1024 / sizeof(Entry));
+    while (count & (count - 1)) count &= count - 1;
+    m_entries = std::make_unique<Entry[]>(count);
+    m_mask = count - 1;
+}
+
+bool PerftHash::probe(uint64_t key, int depth, uint64_t& nodes) const {
+    const uint64_t k = key_for(key, depth);
+    const Entry& e = m_entries[k & m_mask];
+    uint64_t n = e.nodes.load(std::memory_order_relaxed);
+    if ((e.check.load(std::memory_order_relaxed) ^ n) != k) return false;
+    nodes = n;
+    return true;
+}
+
+void PerftHash::store(uint64_t key, int depth, uint64_t nodes) {
+    const uint64_t k = key_for(key, depth);
+    Entry& e = m_entries[k & m_mask];
+    e.check.store(k ^ nodes, std::memory_order_relaxed);
+    e.nodes.store(nodes, std::memory_order_relaxed);
+}
+
+namespace {
+
+uint64_t perft_nodes(Board& board, int depth, PerftHash* hash) {
+    uint64_t nodes = 0;
+    if (depth >= 2 && hash && hash->probe(board.get_zobrist_key(), depth, nodes)) {
+        return nodes;
+    }
+
+    MoveList moves;
+    board.generate_legal_moves(moves);
+    if (depth <= 1) return moves.size();
+
+    for (const Move& move : moves) {
+        board.make_move(move);
+        nodes += perft_nodes(board, depth - 1, hash);
+        board.unmake_move(move);
+    }
+
+    if (hash) hash->store(board.get_zobrist_key(), depth, nodes);
+    return nodes;
+}
+
+} // namespace
+
+PerftResult perft(const Board& board, int depth, int threads, PerftHash* hash) {
+    PerftResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    MoveList root_moves;
+    board.generate_legal_moves(root_moves);
+
+    if (depth <= 0) {
+        result.nodes = 1;
+    } else {
+        std::vector<uint64_t> counts(root_moves.size());
+        std::atomic<size_t> next{0};
+
+        auto worker = [&]() {
+            Board local = board;
+            for (size_t i = next++; i < root_moves.size(); i = next++) {
+                if (depth == 1) {
+                    counts[i] = 1;
+                    continue;
+                }
+                local.make_move(root_moves[i]);
+                counts[i] = perft_nodes(local, depth - 1, hash);
+                local.unmake_move(root_moves[i]);
+            }
+        };
+
+        threads = std::clamp<int>(threads, 1, std::max<int>(1, root_moves.size()));
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : pool) {
+            t.join();
+        }
+
+        for (size_t i = 0; i < root_moves.size(); ++i) {
+            result.divide.emplace_back(root_moves[i], counts[i]);
+            result.nodes += counts[i];
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void print_perft(std::ostream& out, const PerftResult& result, bool divide) {
+    if (divide) {
+        for (const auto& [move, nodes] : result.divide) {
+            out << move_to_uci(move) << ": " << nodes << "\n";
+        }
+        out << "\n";
+    }
+    out << "Nodes searched: " << result.nodes << "\n"
+        << "Time: " << uint64_t(result.seconds * 1000) << " ms"
+        << "  NPS: " << uint64_t(result.seconds > 0 ? result.nodes / result.seconds : 0) << "\n";
+}
+
+} // namespace ViperChess
@@ -0,0 +1,52 @@
+// perft.hpp
+#pragma once
+#include "board.hpp"
+#include <atomic>
+#include <iosfwd>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ViperChess {
+
+// Node-count cache shared by all perft threads, keyed by the Zobrist key
+// and depth. Each slot keeps the count next to (key ^ count), so a slot
+// torn by a concurrent writer fails verification instead of returning a
+// wrong count.
+class PerftHash {
+public:
+    explicit PerftHash(size_t mb_size);
+
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const;
+    void store(uint64_t key, int depth, uint64_t nodes);
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> nodes;
+    };
+
+    static uint64_t key_for(uint64_t key, int depth) {
+        return key ^ (uint64_t(depth) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_mask;
+};
+
+struct PerftResult {
+    uint64_t nodes = 0;
+    double seconds = 0;
+    std::vector<std::pair<Move, uint64_t>> divide;  // Per root move, in generation order
+};
+
+// Counts the leaf nodes of the legal move tree to `depth`. The last ply is
+// counted from the move list without making the moves (bulk counting).
+// Root moves are handed out to `threads` workers, each searching its own
+// copy of the board.
+PerftResult perft(const Board& board, int depth, int threads, PerftHash* hash = nullptr);
+
+// "e2e4: 20" per root move when `divide` is set, then totals and NPS
+void print_perft(std::ostream& out, const PerftResult& result, bool divide);
+
+} // namespace ViperChess
@@ -0,0 +1,127 @@
+// perft_main.cpp
+// Standalone move generator check. Usage:
+//   viperchess-perft [--divide] [--threads N] [--hash MB] <depth> [fen]
+// Without a FEN the start position is used.
+#include "board.hpp"
+#include "perft.hpp"
+#include <cctype>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr const char* USAGE = "usage: viperchess-perft [--divide] [--threads N] [--hash MB] <depth> [fen]\n";
+
+// A whole argument as a non-negative int; throws std::invalid_argument or
+// std::out_of_range otherwise
+int parse_count(const std::string& arg) {
+    size_t used = 0;
+    int value = std::stoi(arg, &used);
+    if (used != arg.size() || value < 0) throw std::invalid_argument(arg);
+    return value;
+}
+
+// Board::set_fen trusts its input, so anything it could misread is caught
+// here: placement, side, castling, en passant and the optional clocks. The
+// clocks default to "0 1" when left off, as in EPD. Returns the FEN to set,
+// or an empty string.
+std::string checked_fen(const std::string& fen) {
+    std::istringstream iss(fen);
+    std::vector<std::string> fields;
+    for (std::string field; iss >> field;) fields.push_back(field);
+    if (fields.size() < 4 || fields.size() > 6) return "";
+
+    int rank = 0, file = 0;
+    for (char c : fields[0]) {
+        if (c == '/') {
+            if (file != 8 || ++rank > 7) return "";
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+        } else if (std::string("pnbrqkPNBRQK").find(c) != std::string::npos) {
+            ++file;
+        } else {
+            return "";
+        }
+        if (file > 8) return "";
+    }
+    if (rank != 7 || file != 8) return "";
+
+    if (fields[1] != "w" && fields[1] != "b") return "";
+    if (fields[2] != "-" && fields[2].find_first_not_of("KQkq") != std::string::npos) return "";
+    const std::string& ep = fields[3];
+    if (ep != "-" && (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h' || (ep[1] != '3' && ep[1] != '6'))) return "";
+    for (size_t i = 4; i < fields.size(); ++i) {
+        if (fields[i].find_first_not_of("0123456789") != std::string::npos) return "";
+    }
+
+    if (fields.size() < 5) fields.push_back("0");
+    if (fields.size() < 6) fields.push_back("1");
+    std::string checked;
+    for (const std::string& field : fields) checked += (checked.empty() ? "" : " ") + field;
+    return checked;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace ViperChess;
+
+    bool divide = false;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int hash_mb = 64;
+    int depth = -1;
+    std::string fen;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--divide") {
+                divide = true;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                threads = std::max(1, parse_count(argv[++i]));
+            } else if (arg == "--hash" && i + 1 < argc) {
+                hash_mb = parse_count(argv[++i]);
+            } else if (depth < 0) {
+                depth = parse_count(arg);
+            } else {
+                fen += (fen.empty() ? "" : " ") + arg;
+            }
+        }
+    } catch (const std::logic_error&) {  // invalid_argument, out_of_range
+        depth = -1;
+    }
+
+    if (depth < 0) {
+        std::cerr << USAGE;
+        return 1;
+    }
+
+    Board board;
+    if (!fen.empty()) {
+        const std::string checked = checked_fen(fen);
+        if (checked.empty()) {
+            std::cerr << "invalid FEN: " << fen << "\n" << USAGE;
+            return 1;
+        }
+        board.set_fen(checked);
+        for (Color color : {WHITE, BLACK}) {
+            if (count_bits(board.get_pieces(color, KING)) != 1) {
+                std::cerr << "invalid FEN, not one king per side: " << fen << "\n" << USAGE;
+                return 1;
+            }
+        }
+    }
+
+    std::unique_ptr<PerftHash> hash;
+    if (hash_mb > 0) {
+        hash = std::make_unique<PerftHash>(hash_mb);
+    }
+
+    print_perft(std::cout, perft(board, depth, threads, hash.get()), divide);
+    return 0;
+}
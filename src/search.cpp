@@ -1,296 +1,544 @@
-#include "search.hpp"
-#include <algorithm>
-#include <iostream>
-#include <thread>
-#include <atomic>
-#include <cstring>  // Add this for memset
-
-namespace ViperChess {
-
-Searcher::Searcher(Evaluator& evaluator, OpeningBook* book)
-    : m_evaluator(evaluator), 
-      m_book(book),
-      m_tt(16),  // Initialize transposition table with 16MB
-      m_running(false),
-      m_nodes(0),
-      m_ply(0)
-{
-    // Initialize killer moves and history heuristics
-    std::memset(m_killer_moves, 0, sizeof(m_killer_moves));
-    std::memset(m_history, 0, sizeof(m_history));
-}
-
-Move Searcher::probe_book(const Board& board) const {
-    if (!m_book || board.get_fullmove_number() > 20) {
-        return Move::none();
-    }
-    
-    // This will now work since book.hpp is fully included
-    Move book_move = m_book->probe(board);
-    if (book_move.is_valid() && board.is_legal(book_move)) {
-        return book_move;
-    }
-    return Move::none();
-}
-
-SearchResult Searcher::search(const Board& board, const SearchParams& params) {
-    m_params = params;
-    m_start_time = std::chrono::steady_clock::now();
-    m_nodes = 0;
-    m_ply = 0;
-    
-    Board temp_board = board;
-    SearchResult result;
-    int alpha = -INF;
-    int beta = INF;
-
-    Move book_move = probe_book(board);
-    if (book_move.is_valid()) {
-        SearchResult result;
-        result.best_move = book_move;
-        result.score = 0; // Book moves are considered equal
-        result.depth = 0;
-        result.nodes = 0;
-        return result;
-    }
-
-
-    if (m_stop && m_stop->load()) {
-        return SearchResult{}; // Early exit if stopped
-    }
-
-    // Iterative deepening
-    for (int depth = 1; depth <= m_params.depth; ++depth) {
-        std::vector<Move> moves = temp_board.generate_legal_moves();
-        order_moves(temp_board, moves, Move(A1, A1)); // Default empty move
-
-        for (const Move& move : moves) {
-            Board new_board = temp_board;
-            new_board.make_move(move);
-            m_nodes++;
-            m_ply++;
-
-            int score = -alpha_beta(new_board, depth - 1, -beta, -alpha, true);
-            m_ply--;
-
-            if (score > alpha) {
-                alpha = score;
-                result.best_move = move;
-                result.score = score;
-                result.depth = depth;
-            }
-
-            if (time_elapsed() && m_params.use_time) {
-                goto finish_search;
-            }
-        }
-    }
-
-    finish_search:
-    result.nodes = m_nodes;
-
-    if (m_nodes % 1000 == 0 && m_stop && m_stop->load()) {
-        return SearchResult{};
-    }
-    return result;
-}
-
-int Searcher::alpha_beta(Board& board, int depth, int alpha, int beta, bool null_move) {
-    if (depth <= 0) {
-        return quiescence(board, alpha, beta);
-    }
-
-    // Null move pruning
-    if (null_move && depth >= 3 && !board.is_in_check(board.get_side_to_move())) {
-        Board temp = board;
-        temp.make_null_move();
-        m_ply++;
-        int score = -alpha_beta(temp, depth - 1 - 2, -beta, -beta + 1, false);
-        m_ply--;
-        if (score >= beta) return beta;
-    }
-
-    std::vector<Move> moves = board.generate_legal_moves();
-    order_moves(board, moves, Move(A1, A1));
-
-    for (const Move& move : moves) {
-        Board new_board = board;
-        new_board.make_move(move);
-        m_nodes++;
-        m_ply++;
-
-        int score = -alpha_beta(new_board, depth - 1, -beta, -alpha, true);
-        m_ply--;
-
-        if (score >= beta) return beta;
-        if (score > alpha) alpha = score;
-    }
-
-    return alpha;
-}
-
-
-
-int Searcher::quiescence(Board& board, int alpha, int beta) {
-    int stand_pat = m_evaluator.evaluate(board);
-    if (stand_pat >= beta) return beta;
-    if (stand_pat > alpha) alpha = stand_pat;
-
-    std::vector<Move> captures;
-    for (const Move& move : board.generate_legal_moves()) {
-        if (board.piece_at(move.to).type != NONE_PIECE) {
-            captures.push_back(move);
-        }
-    }
-
-    for (const Move& move : captures) {
-        Board new_board = board;
-        new_board.make_move(move);
-        m_nodes++;
-        m_ply++;
-
-        int score = -quiescence(new_board, -beta, -alpha);
-        m_ply--;
-
-        if (score >= beta) return beta;
-        if (score > alpha) alpha = score;
-    }
-
-    return alpha;
-}
-
-int Searcher::pvs(Board& board, int depth, int alpha, int beta, bool null_move) {
-    if (depth <= 0) return quiescence(board, alpha, beta);
-    
-    std::vector<Move> moves = board.generate_legal_moves();
-    order_moves(board, moves, Move(A1, A1)); // Default empty move
-    
-    bool first_move = true;
-    for (const Move& move : moves) {
-        Board new_board = board;
-        new_board.make_move(move);
-        m_nodes++;
-        
-        int score;
-        if (first_move) {
-            score = -pvs(new_board, depth-1, -beta, -alpha, true);
-            first_move = false;
-        } else {
-            score = -pvs(new_board, depth-1, -alpha-1, -alpha, true);
-            if (score > alpha)
-                score = -pvs(new_board, depth-1, -beta, -alpha, true);
-        }
-        
-        if (score >= beta) return beta;
-        if (score > alpha) alpha = score;
-    }
-    return alpha;
-}
-
-int calculate_lmr(int depth, int move_number) {
-    if (depth >= 3 && move_number >= 4) {
-        return 1 + log(depth) * log(move_number) / 2;
-    }
-    return 0;
-}
-
-void Searcher::order_moves(Board& board, std::vector<Move>& moves, Move tt_move) {
-    std::sort(moves.begin(), moves.end(), [&](const Move& a, const Move& b) {
-        // 1. TT move first
-        if (a == tt_move) return true;
-        if (b == tt_move) return false;
-
-        // 2. Captures (MVV-LVA)
-        int a_cap = piece_value(board.piece_at(a.to).type);
-        int b_cap = piece_value(board.piece_at(b.to).type);
-        if (a_cap != b_cap) return a_cap > b_cap;
-
-        // 3. Killer moves
-        for (int i = 0; i < 2; ++i) {
-            if (a == m_killer_moves[m_ply][i]) return true;
-            if (b == m_killer_moves[m_ply][i]) return false;
-        }
-
-        // 4. History heuristic
-        Color stm = board.get_side_to_move();
-
-        //a.lmr_reduction = calculate_lmr(depth, move_number);
-
-        return m_history[stm][a.from][a.to] > m_history[stm][b.from][b.to];
-    });
-}
-
-void Searcher::adjust_time(int move_number, int time_left, int increment) {
-    // Allocate more time for critical moments
-    float factor = 1.0f;
-    if (move_number < 10) factor = 0.8f; // Opening
-    else if (move_number < 30) factor = 1.0f; // Middlegame
-    else factor = 1.2f; // Endgame
-    
-    m_params.time_ms = std::min(time_left / 30, 
-                               static_cast<int>((time_left * 0.05 + increment * 0.8) * factor));
-}
-
-bool Searcher::time_elapsed() const {
-    if (m_params.infinite) return false;
-    auto elapsed = std::chrono::steady_clock::now() - m_start_time;
-    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= m_params.time_ms;
-}
-
-void Searcher::parallel_search(const Board& board, SearchParams params) {
-    // Create thread-safe stop flag
-    std::atomic<bool> stop_flag(false);
-    m_stop = &stop_flag;
-    
-    // Get number of threads
-    const int num_threads = Searcher::get_num_threads();
-    
-    // Create thread pool and results
-    std::vector<std::thread> threads;
-    std::vector<SearchResult> results;
-    results.reserve(num_threads);
-    
-    // Create a shared transposition table
-    TranspositionTable shared_tt(16); // 16MB
-    
-    for (int i = 0; i < num_threads; i++) {
-        threads.emplace_back([this, &board, params, &results, i, &stop_flag, &shared_tt]() {
-            Board local_board = board;
-            Searcher local_searcher(m_evaluator);
-            local_searcher.m_tt = shared_tt; // Share the TT by copy
-            local_searcher.m_stop = &stop_flag;
-            
-            // Different search depths for each thread (Lazy SMP)
-            SearchParams local_params = params;
-            local_params.depth += i % 2;
-            
-            SearchResult result = local_searcher.search(local_board, local_params);
-            results.push_back(result);
-            
-            // First thread to finish stops the others
-            if (i == 0 && !stop_flag.load()) {
-                stop_flag.store(true);
-            }
-        });
-    }
-    
-    // Wait for all threads to finish
-    for (auto& t : threads) {
-        if (t.joinable()) {
-            t.join();
-        }
-    }
-    
-    // Find best result
-    if (!results.empty()) {
-        auto best_result = std::max_element(results.begin(), results.end(),
-            [](const SearchResult& a, const SearchResult& b) {
-                return a.score < b.score;
-            });
-        
-        // Update main transposition table from shared one
-        m_tt = shared_tt;
-    }
-}
-
+#include "search.hpp"
+#include "movegen.hpp"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <cstring>  // Add this for memset
+#include <array>
+#include <cmath>
+
+namespace ViperChess {
+
+namespace {
+
+// Iterations from this depth on start with a window this wide around the
+// previous score, doubled on every fail-high or fail-low re-search
+constexpr int ASPIRATION_DEPTH = 4;
+constexpr int ASPIRATION_WINDOW = 50;
+
+// Futility margins by remaining depth: a quiet move at a frontier node
+// (depth 1) is skipped when the static eval plus a minor piece cannot reach
+// alpha, at a pre-frontier node (depth 2) when a rook's worth cannot
+constexpr int FUTILITY_MARGIN[3] = {0, 300, 500};
+
+// SEE pruning in the main search: at depth d or below SEE_PRUNING_DEPTH, a
+// capture may lose up to SEE_CAPTURE_MARGIN * d and a quiet move up to
+// SEE_QUIET_MARGIN * d * d before it is skipped
+constexpr int SEE_PRUNING_DEPTH = 4;
+constexpr int SEE_CAPTURE_MARGIN = 100;
+constexpr int SEE_QUIET_MARGIN = 30;
+
+// Late move reductions by [depth][move number], the 1-based position of the
+// move in the ordered list: 1 + ln(depth) * ln(move number) / 2 from the
+// fourth move on at depth 3 and above, none before
+const auto LMR_TABLE = [] {
+    std::array<std::array<int, MAX_MOVES>, MAX_PLY> table{};
+    for (int depth = 3; depth < MAX_PLY; ++depth) {
+        for (int number = 4; number < MAX_MOVES; ++number) {
+            table[depth][number] = int(1 + std::log(depth) * std::log(number) / 2);
+        }
+    }
+    return table;
+}();
+
+// Mate scores count plies from the root, but a TT entry may be read at any
+// ply, so they are stored relative to the node itself
+int score_to_tt(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY) return score + ply;
+    if (score <= -MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+int score_from_tt(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY) return score - ply;
+    if (score <= -MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
+
+// History bonus for a cutoff at `depth`
+int stat_bonus(int depth) {
+    return std::min(depth * depth, 1200);
+}
+
+// Each update moves the entry towards +-HISTORY_MAX by a share of the
+// remaining distance, so entries stay bounded without periodic scaling
+template <typename T>
+void update_history(T& entry, int delta) {
+    entry += delta - entry * std::abs(delta) / HISTORY_MAX;
+}
+
+PieceType captured_type(const Board& board, Move move) {
+    return move.is_en_passant() ? PAWN : board.piece_at(move.to()).type;
+}
+
+} // namespace
+
+Searcher::Searcher(Evaluator& evaluator, OpeningBook* book)
+    : m_evaluator(evaluator), 
+      m_book(book),
+      m_running(false),
+      m_nodes(0),
+      m_continuation_history(new PieceToHistory[NUM_PIECE_INDICES * 64]),
+      m_ply(0)
+{
+    clear();
+}
+
+void Searcher::clear() {
+    std::memset(m_history, 0, sizeof(m_history));
+    std::memset(m_capture_history, 0, sizeof(m_capture_history));
+    std::memset(m_continuation_history.get(), 0, sizeof(PieceToHistory) * NUM_PIECE_INDICES * 64);
+    std::memset(m_counter_moves, 0, sizeof(m_counter_moves));
+}
+
+Move Searcher::probe_book(const Board& board) const {
+    if (!m_book || board.get_fullmove_number() > 20) {
+        return Move::none();
+    }
+    
+    // This will now work since book.hpp is fully included
+    Move book_move = m_book->probe(board);
+    if (book_move.is_valid() && board.is_legal(book_move)) {
+        return book_move;
+    }
+    return Move::none();
+}
+
+SearchResult Searcher::search(const Board& board, const SearchParams& params) {
+    m_params = params;
+    m_params.depth = std::min(params.depth, MAX_DEPTH + 1);  // Helpers go one deeper
+    m_start_time = m_clock_start = std::chrono::steady_clock::now();
+    m_time.init(m_params, board.get_side_to_move());
+    m_nodes = 0;
+    m_cutoffs = 0;
+    m_first_move_cutoffs = 0;
+    m_ply = 0;
+    // Killers are by distance from the root, which moves between searches;
+    // histories and counter-moves carry over
+    std::fill(std::begin(m_stack), std::end(m_stack), SearchStack());
+    m_pondering = params.ponder && m_ponder;
+    if (m_stop == &m_own_stop) {
+        m_own_stop.store(false, std::memory_order_relaxed);
+    }
+    
+    m_board = board; // The whole search runs on this one board
+    SearchResult result;
+    m_pv_length[0] = 0;
+
+    Move book_move = params.use_book ? probe_book(board) : Move::none();
+    if (book_move.is_valid()) {
+        SearchResult result;
+        result.best_move = book_move;
+        result.pv.push_back(book_move);
+        result.score = 0; // Book moves are considered equal
+        result.depth = 0;
+        result.nodes = 0;
+        return result;
+    }
+
+    MoveList moves;
+    m_board.generate_legal_moves(moves);
+    if (moves.empty()) {
+        result.score = m_board.is_in_check(m_board.get_side_to_move()) ? -MATE : 0;
+        return result;
+    }
+
+    // Iterative deepening. An iteration's result is only taken once all its
+    // root moves are searched inside its window; from ASPIRATION_DEPTH on
+    // the window starts narrow around the previous score.
+    Move best_move = Move::none();
+    int stable_iterations = 0;
+    for (int depth = 1; depth <= m_params.depth; ++depth) {
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -INF;
+        int beta = INF;
+        if (depth >= ASPIRATION_DEPTH) {
+            alpha = std::max(result.score - delta, -INF);
+            beta = std::min(result.score + delta, INF);
+        }
+
+        int score;
+        while (true) {
+            m_root_best = best_move;
+            score = search<ROOT>(m_board, depth, alpha, beta);
+            best_move = m_root_best;
+            if (stopped()) break;
+
+            if (score <= alpha) {
+                alpha = std::max(alpha - delta, -INF);
+            } else if (score >= beta) {
+                beta = std::min(beta + delta, INF);
+            } else {
+                break;
+            }
+            delta *= 2;
+        }
+
+        if (stopped()) {
+            // Before depth 1 is complete any move beats none, so there is
+            // always one to play, even when the stop came before the first
+            // node
+            if (!result.best_move.is_valid()) {
+                result.best_move = best_move.is_valid() ? best_move : moves[0];
+                result.pv.push_back(result.best_move);
+            }
+            break;
+        }
+
+        stable_iterations = best_move == result.best_move ? stable_iterations + 1 : 0;
+        const int score_drop = depth > 1 ? result.score - score : 0;
+        result.best_move = best_move;
+        result.score = score;
+        result.depth = depth;
+        result.pv.clear();
+        for (int i = 0; i < m_pv_length[0]; ++i) {
+            result.pv.push_back(m_pv[0][i]);
+        }
+        result.nodes = m_nodes;
+        result.time_ms = elapsed_ms();
+        if (m_params.on_iteration) m_params.on_iteration(result);
+
+        // On a clock, stop early once the best move has settled, and go on
+        // longer while the score falls
+        if (m_params.use_time && !m_pondering
+            && m_time.stop_iterating(clock_elapsed_ms(), stable_iterations, score_drop)) {
+            break;
+        }
+    }
+
+    result.nodes = m_nodes;
+    result.time_ms = elapsed_ms();
+    result.cutoffs = m_cutoffs;
+    result.first_move_cutoffs = m_first_move_cutoffs;
+    return result;
+}
+
+// Principal variation search. Only the first move of a PV node is searched
+// with the full window; the rest get a null window around alpha, and only
+// one that beats it is searched again as a PV node. Everything that depends
+// on the node type is decided at compile time:
+//   ROOT:    one pass over the root moves, m_root_best (the previous
+//            iteration's best move, or the last re-search's) first; after
+//            each move the clock is checked. No pruning, TT or history
+//            updates; m_root_best and the root PV change only when a move
+//            raises alpha.
+//   PV:      builds the PV; no TT cutoffs, so the PV is not cut short, and
+//            no null move.
+//   NON_PV:  null window, by far the most nodes; TT cutoffs and null move.
+// Fails hard: the score is clamped to [alpha, beta].
+template <Searcher::NodeType NT>
+int Searcher::search(Board& board, int depth, int alpha, int beta) {
+    constexpr bool root = NT == ROOT;
+    constexpr bool pv_node = NT != NON_PV;
+
+    if constexpr (pv_node) m_pv_length[m_ply] = m_ply;
+
+    // Drawn by repetition or the fifty-move rule. A line that can head back
+    // to a position already in it is worth at least the draw, so it is cut
+    // before being played out.
+    if constexpr (!root) {
+        if (board.is_draw(m_ply)) return 0;
+        if (alpha < 0 && board.has_upcoming_repetition(m_ply)) {
+            alpha = 0;
+            if (alpha >= beta) return beta;
+        }
+    }
+
+    // Also the ply cap, which quiescence enforces
+    if (depth <= 0 || m_ply >= MAX_PLY) {
+        return quiescence(board, alpha, beta);
+    }
+
+    // Stopped or out of time; the caller throws the score away
+    if constexpr (!root) {
+        if (poll_stop()) return 0;
+    }
+
+    const uint64_t key = board.get_zobrist_key();
+    TTData tt;
+    const bool tt_hit = !root && TT.probe(key, tt);
+    const Move tt_move = root ? m_root_best : tt_hit ? tt.move : Move::none();
+    if constexpr (!pv_node) {
+        if (tt_hit && tt.depth >= depth) {
+            const int tt_score = score_from_tt(tt.score, m_ply);
+            if (tt.flag == EXACT) return tt_score;
+            if (tt.flag == LOWER_BOUND && tt_score >= beta) return tt_score;
+            if (tt.flag == UPPER_BOUND && tt_score <= alpha) return tt_score;
+        }
+    }
+
+    const bool in_check = board.is_in_check(board.get_side_to_move());
+
+    // Interior nodes evaluate only where futility pruning needs it; the
+    // eval goes into the TT entry for later visits
+    int static_eval = tt_hit ? tt.eval : EVAL_NONE;
+    bool futile = false;
+    if (!root && m_params.futility && depth <= 2 && !in_check && std::abs(alpha) < MATE_IN_MAX_PLY) {
+        if (static_eval == EVAL_NONE) static_eval = m_evaluator.evaluate(board);
+        futile = static_eval + FUTILITY_MARGIN[depth] <= alpha;
+    }
+
+    // Null move pruning, never twice in a row
+    SearchStack* ss = stack(m_ply);
+    if constexpr (!pv_node) {
+        if (depth >= 3 && !in_check && stack(m_ply - 1)->move.is_valid()) {
+            ss->move = Move::none();
+            ss->piece = Piece::NONE;
+            ss->continuation = nullptr;
+            board.make_null_move();
+            m_ply++;
+            int score = -search<NON_PV>(board, depth - 1 - 2, -beta, -beta + 1);
+            m_ply--;
+            board.unmake_null_move();
+            if (stopped()) return 0;
+            if (score >= beta) return beta;
+        }
+    }
+
+    const SearchStack* previous = stack(m_ply - 1);
+    const Move counter_move = previous->move.is_valid()
+                            ? m_counter_moves[piece_index(previous->piece)][previous->move.to()] : Move::none();
+    const PieceToHistory* continuation[2] = {previous->continuation, stack(m_ply - 2)->continuation};
+    MovePicker picker(board, tt_move, ss->killers, counter_move, m_history, m_capture_history, continuation);
+    const Bitboard pinned = board.pinned_pieces(board.get_side_to_move());
+    const Bitboard checkers = board.checkers();
+
+    const int original_alpha = alpha;
+    Move best_move = Move::none();
+    int move_number = 0;
+    Move quiets_tried[64];
+    int quiet_count = 0;
+    Move captures_tried[32];
+    int capture_count = 0;
+
+    for (Move move = picker.next_move(); move.is_valid(); move = picker.next_move()) {
+        if (!board.is_legal(move, pinned, checkers)) continue;
+
+        ++move_number;
+        const bool quiet = board.is_empty(move.to()) && !move.is_en_passant() && move.promotion() == NONE_PIECE;
+        const int reduction = !root && m_params.lmr && quiet && !in_check
+                            ? LMR_TABLE[depth][std::min(move_number, MAX_MOVES - 1)] : 0;
+
+        // Near the leaves, once one move is searched, skip moves that give
+        // away more material by SEE than the remaining depth could win back
+        if (!root && m_params.see_pruning && depth <= SEE_PRUNING_DEPTH && !in_check && move_number > 1
+            && std::abs(alpha) < MATE_IN_MAX_PLY
+            && !board.see_ge(move, quiet ? -SEE_QUIET_MARGIN * depth * depth : -SEE_CAPTURE_MARGIN * depth)) {
+            continue;
+        }
+
+        push_move(board, move);
+        board.make_move(move);
+
+        // Checking moves are neither pruned nor reduced
+        const bool gives_check = quiet && (futile || reduction > 0)
+                              && board.is_in_check(board.get_side_to_move());
+        if (futile && quiet && !gives_check) {
+            board.unmake_move(move);
+            continue;
+        }
+
+        m_nodes++;
+        m_ply++;
+
+        // A late quiet move is first searched shallower; only if it beats
+        // alpha there does it get the full depth
+        int score = 0;
+        bool full_depth_null_window;
+        if (reduction > 0 && !gives_check) {
+            const int reduced = depth - 1 - std::min(reduction, depth - 2);
+            score = -search<NON_PV>(board, reduced, -alpha - 1, -alpha);
+            full_depth_null_window = score > alpha;
+        } else {
+            full_depth_null_window = !pv_node || move_number > 1;
+        }
+        if (full_depth_null_window) {
+            score = -search<NON_PV>(board, depth - 1, -alpha - 1, -alpha);
+        }
+        if (pv_node && (move_number == 1 || (score > alpha && (root || score < beta)))) {
+            score = -search<PV>(board, depth - 1, -beta, -alpha);
+        }
+        m_ply--;
+        board.unmake_move(move);
+
+        if constexpr (root) {
+            check_time();
+            if (stopped()) return 0;  // The interrupted move's score is meaningless
+
+            if (score > alpha) {
+                alpha = score;
+                m_root_best = move;
+                update_pv(move);
+                if (score >= beta) return beta;
+            }
+            continue;
+        }
+
+        if (stopped()) return 0;
+
+        if (score >= beta) {
+            ++m_cutoffs;
+            m_first_move_cutoffs += move_number == 1;
+            if (quiet) update_quiet_stats(move, depth, quiets_tried, quiet_count);
+            update_capture_stats(quiet ? Move::none() : move, depth, captures_tried, capture_count);
+            TT.store(key, depth, score_to_tt(beta, m_ply), static_eval, move, LOWER_BOUND);
+            return beta;
+        }
+        if (score > alpha) {
+            alpha = score;
+            best_move = move;
+            if constexpr (pv_node) update_pv(move);
+        }
+        if (quiet && quiet_count < 64) {
+            quiets_tried[quiet_count++] = move;
+        } else if (!quiet && capture_count < 32) {
+            captures_tried[capture_count++] = move;
+        }
+    }
+
+    // The root always has a legal move and stores nothing
+    if constexpr (root) return alpha;
+
+    if (move_number == 0) {
+        // Checkmate, or stalemate
+        return in_check ? -MATE + m_ply : 0;
+    }
+
+    TT.store(key, depth, score_to_tt(alpha, m_ply), static_eval, best_move,
+             alpha > original_alpha ? EXACT : UPPER_BOUND);
+    return alpha;
+}
+
+int Searcher::quiescence(Board& board, int alpha, int beta) {
+    m_pv_length[m_ply] = m_ply;  // Quiescence lines are not reported
+    if (poll_stop()) return 0;
+    if (m_ply >= MAX_PLY) return m_evaluator.evaluate(board);
+
+    int stand_pat = m_evaluator.evaluate(board);
+    if (stand_pat >= beta) return beta;
+    if (stand_pat > alpha) alpha = stand_pat;
+
+    MovePicker picker(board, m_capture_history);
+    const Bitboard pinned = board.pinned_pieces(board.get_side_to_move());
+    const Bitboard checkers = board.checkers();
+
+    for (Move move = picker.next_move(); move.is_valid(); move = picker.next_move()) {
+        if (!board.is_legal(move, pinned, checkers)) continue;
+
+        // A capture that loses material cannot lift the score above stand pat
+        if (m_params.see_pruning && !board.see_ge(move, 0)) continue;
+
+        // The frames describe the line at every ply, quiescence included
+        push_move(board, move);
+        board.make_move(move);
+        m_nodes++;
+        m_ply++;
+
+        int score = -quiescence(board, -beta, -alpha);
+        m_ply--;
+        board.unmake_move(move);
+
+        if (stopped()) return 0;
+
+        if (score >= beta) return beta;
+        if (score > alpha) alpha = score;
+    }
+
+    return alpha;
+}
+
+void Searcher::push_move(const Board& board, Move move) {
+    SearchStack* ss = stack(m_ply);
+    ss->move = move;
+    ss->piece = board.piece_at(move.from());
+    ss->continuation = &m_continuation_history[piece_index(ss->piece) * 64 + move.to()];
+}
+
+// A quiet move cut off: it becomes the first killer of this ply and the
+// answer to the opponent's last move, and gains history while the quiet
+// moves tried before it lose some
+void Searcher::update_quiet_stats(Move move, int depth, const Move* quiets_tried, int quiet_count) {
+    Move* killers = stack(m_ply)->killers;
+    if (killers[0] != move) {
+        killers[1] = killers[0];
+        killers[0] = move;
+    }
+
+    const SearchStack* previous = stack(m_ply - 1);
+    if (previous->move.is_valid()) {
+        m_counter_moves[piece_index(previous->piece)][previous->move.to()] = move;
+    }
+
+    const int bonus = stat_bonus(depth);
+    int* history = m_history[m_board.get_side_to_move()];
+    update_history(history[move.from_to()], bonus);
+    update_continuation(m_board.piece_at(move.from()), move.to(), bonus);
+    for (int i = 0; i < quiet_count; ++i) {
+        update_history(history[quiets_tried[i].from_to()], -bonus);
+        update_continuation(m_board.piece_at(quiets_tried[i].from()), quiets_tried[i].to(), -bonus);
+    }
+}
+
+// `move` is the capture that cut off, or none when a quiet move did; either
+// way the captures tried before it failed to and lose capture history
+void Searcher::update_capture_stats(Move move, int depth, const Move* captures_tried, int capture_count) {
+    const int bonus = stat_bonus(depth);
+    auto entry = [this](Move capture) -> int16_t& {
+        return m_capture_history[piece_index(m_board.piece_at(capture.from()))][capture.to()]
+                                [captured_type(m_board, capture)];
+    };
+    if (move.is_valid()) update_history(entry(move), bonus);
+    for (int i = 0; i < capture_count; ++i) {
+        update_history(entry(captures_tried[i]), -bonus);
+    }
+}
+
+// The move is a reply to our opponent's last move and a follow-up to our
+// own move before it
+void Searcher::update_continuation(Piece piece, Square to, int bonus) {
+    for (int back = 1; back <= 2; ++back) {
+        PieceToHistory* continuation = stack(m_ply - back)->continuation;
+        if (continuation) update_history((*continuation)[piece_index(piece)][to], bonus);
+    }
+}
+
+void Searcher::update_pv(Move move) {
+    const int ply = m_ply;
+    assert(ply < MAX_PLY && m_pv_length[ply + 1] <= MAX_PLY);
+    m_pv[ply][ply] = move;
+    for (int i = ply + 1; i < m_pv_length[ply + 1]; ++i) {
+        m_pv[ply][i] = m_pv[ply + 1][i];
+    }
+    m_pv_length[ply] = std::max(m_pv_length[ply + 1], ply + 1);
+}
+
+int64_t Searcher::elapsed_ms() const {
+    auto elapsed = std::chrono::steady_clock::now() - m_start_time;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+int64_t Searcher::clock_elapsed_ms() const {
+    auto elapsed = std::chrono::steady_clock::now() - m_clock_start;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+bool Searcher::time_elapsed() const {
+    if (m_params.infinite) return false;
+    return clock_elapsed_ms() >= m_time.maximum();
+}
+
+void Searcher::check_time() {
+    // After ponderhit the opponent played the expected move and our clock
+    // runs, so the time budget counts from here. Reported times still count
+    // from the start, like the nodes searched while pondering.
+    if (m_pondering && !m_ponder->load(std::memory_order_relaxed)) {
+        m_pondering = false;
+        m_clock_start = std::chrono::steady_clock::now();
+    }
+    if (m_params.use_time && !m_pondering && time_elapsed()) {
+        m_stop->store(true, std::memory_order_relaxed);
+    }
+}
+
 } // namespace ViperChess
\ No newline at end of file
@@ -1,140 +1,169 @@
-#pragma once
-#include "board.hpp"
-#include "eval.hpp"
-#include "book.hpp"  // Add this include instead of forward declaration
-#include <limits> // For INT_MAX
-#include <chrono>
-#include <stdio.h>
-#include <atomic>
-#include <thread>
-
-namespace ViperChess {
-
-constexpr int INF = std::numeric_limits<int>::max();
-
-
-
-enum TTFlag {
-    EXACT,
-    LOWER_BOUND,
-    UPPER_BOUND
-};
-
-
-struct TTEntry {
-    uint64_t key;
-    int depth;
-    int score;
-    Move best_move;
-    uint8_t flag; // EXACT, LOWER_BOUND, UPPER_BOUND
-};
-
-class TranspositionTable {
-    std::vector<TTEntry> table;
-    size_t size;
-    
-public:
-    TranspositionTable(size_t mb_size) {
-        size = (mb_size * 1024 * 1024) / sizeof(TTEntry);
-        table.resize(size);
-    }
-    
-    // Copy constructor
-    TranspositionTable(const TranspositionTable& other) {
-        size = other.size;
-        table = other.table;
-    }
-    
-    // Copy assignment
-    TranspositionTable& operator=(const TranspositionTable& other) {
-        if (this != &other) {
-            size = other.size;
-            table = other.table;
-        }
-        return *this;
-    }
-    
-    void store(uint64_t key, int depth, int score, Move move, uint8_t flag) {
-        size_t index = key % size;
-        if (depth >= table[index].depth) {
-            table[index] = {key, depth, score, move, flag};
-        }
-    }
-    
-    bool probe(uint64_t key, int depth, int alpha, int beta, int& score, Move& move) {
-        size_t index = key % size;
-        if (table[index].key == key && table[index].depth >= depth) {
-            move = table[index].best_move;
-            score = table[index].score;
-            
-            if (table[index].flag == EXACT) return true;
-            if (table[index].flag == LOWER_BOUND && score >= beta) return true;
-            if (table[index].flag == UPPER_BOUND && score <= alpha) return true;
-        }
-        return false;
-    }
-    
-};
-
-struct SearchParams {
-    int depth = 6;
-    int time_ms = 5000;
-    bool use_time = true;
-    bool infinite = false;
-};
-
-struct SearchResult {
-    Move best_move = {A1, A1};
-    int score = 0;
-    uint64_t nodes = 0;
-    int depth = 0;
-    std::vector<Move> pv;
-    // Remove the TT pointer - we'll handle it differently
-};
-
-class Searcher {
-public:
-    explicit Searcher(Evaluator& evaluator, OpeningBook* book = nullptr);
-    Move probe_book(const Board& board) const;
-    SearchResult search(const Board& board, const SearchParams& params);
-    int pvs(Board& board, int depth, int alpha, int beta, bool null_move);
-    void parallel_search(const Board& board, SearchParams params);
-    int get_num_threads() { return num_threads(); }
-
-private:
-    bool m_running = false;  // Add this line
-    OpeningBook* m_book;  // Non-owning pointer
-    void adjust_time(int move_number, int time_left, int increment);
-    int alpha_beta(Board& board, int depth, int alpha, int beta, bool null_move);
-    int quiescence(Board& board, int alpha, int beta);
-    void order_moves(Board& board, std::vector<Move>& moves, Move tt_move);
-    bool time_elapsed() const;
-    std::atomic<bool>* m_stop = nullptr;
-    static int num_threads() { 
-        static int num = std::thread::hardware_concurrency(); 
-        return num > 0 ? num : 4; // Fallback to 4 if hardware_concurrency fails
-    }
-    TranspositionTable m_tt{16}; // 16MB transposition table
-    Evaluator& m_evaluator;
-    SearchParams m_params;
-    std::chrono::time_point<std::chrono::steady_clock> m_start_time;
-    uint64_t m_nodes = 0;
-    Move m_killer_moves[64][2]; // [ply][slot]
-    int m_history[2][64][64];   // [color][from][to]
-    int m_ply = 0; // Track current ply
-};
-
-// Piece values for move ordering
-constexpr int piece_value(PieceType pt) {
-    switch(pt) {
-        case PAWN: return 100;
-        case KNIGHT: return 320;
-        case BISHOP: return 330;
-        case ROOK: return 500;
-        case QUEEN: return 900;
-        case KING: return 20000;
-        default: return 0;
-    }
-}
-
+#pragma once
+#include "board.hpp"
+#include "eval.hpp"
+#include "book.hpp"  // Add this include instead of forward declaration
+#include "tt.hpp"
+#include "movepick.hpp"
+#include "timeman.hpp"
+#include <limits> // For INT_MAX
+#include <cassert>
+#include <chrono>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <memory>
+
+namespace ViperChess {
+
+// Scores are centipawns from the side to move. A mate found at ply p scores
+// MATE - p, so shorter mates score higher; anything beyond MATE_IN_MAX_PLY
+// is a mate score. INF lies outside every real score.
+constexpr int INF = 32001;
+constexpr int MATE = 32000;
+
+// Deepest iteration the search will start; `go infinite` and `go ponder` run
+// until stopped rather than to the default depth. Quiescence may go further,
+// up to MAX_PLY, where nodes just return their static eval. No line is ever
+// longer than that, so every per-ply table is sized by it.
+constexpr int MAX_DEPTH = 48;
+constexpr int MAX_PLY = 64;
+constexpr int MATE_IN_MAX_PLY = MATE - MAX_PLY;
+
+// The stop flag and the clock are looked at once per this many nodes, in the
+// interior and in quiescence alike
+constexpr uint64_t STOP_CHECK_NODES = 2048;
+
+struct SearchResult {
+    Move best_move = Move::none();
+    int score = 0;
+    uint64_t nodes = 0;
+    int depth = 0;
+    int64_t time_ms = 0;
+    MoveList pv;  // Fixed capacity, so reporting a line never allocates
+    // Beta cutoffs below the root, and how many of them came from the first
+    // legal move tried; their ratio measures move ordering
+    uint64_t cutoffs = 0;
+    uint64_t first_move_cutoffs = 0;
+};
+
+struct SearchParams {
+    int depth = 6;
+    int time_ms = 5000;  // `go movetime`, and the budget when there is no clock
+    bool use_time = true;
+    // `go wtime btime winc binc movestogo`, in ms; time_left is -1 for a side
+    // without a clock. When the side to move has one, the TimeManager sets
+    // the budget from it instead of time_ms.
+    int time_left[NUM_COLORS] = {-1, -1};
+    int increment[NUM_COLORS] = {0, 0};
+    int moves_to_go = 0;     // Until the next time control; 0 for the rest of the game
+    int move_overhead = 10;  // Lost to the GUI and the network on every move
+    // `go nodes`: stop once this many nodes are searched, 0 for no limit.
+    // The tree then depends on nothing but the position, the tables and the
+    // count, so a lone thread without a clock searches the same tree on
+    // every run. With helpers it is the main thread's count.
+    uint64_t nodes = 0;
+    bool infinite = false;
+    bool ponder = false;  // The clock starts at ponderhit
+    bool lmr = true;       // Late move reductions
+    bool futility = true;  // Frontier and pre-frontier futility pruning
+    bool see_pruning = true;  // Losing captures in quiescence, losing moves near the leaves
+    bool use_book = true;  // UCI OwnBook: play a book move, when there is one, without searching
+    // Called after each completed iteration with its score, PV and this
+    // thread's node count so far; only the main search thread calls it
+    std::function<void(const SearchResult&)> on_iteration;
+};
+
+// What a node knows about the line that led to it: one frame per ply from
+// the root to MAX_PLY, written by the main search and quiescence alike, with
+// STACK_LOOKBACK empty frames before the root so a node can always look two
+// moves back. The PV and static evals are kept outside it.
+constexpr int STACK_LOOKBACK = 2;
+constexpr int STACK_SIZE = STACK_LOOKBACK + MAX_PLY + 1;
+
+struct SearchStack {
+    PieceToHistory* continuation = nullptr;  // History of replies to `move`; null for a null move
+    Move move = Move::none();        // Searched from this ply; none for a null move
+    Piece piece = Piece::NONE;       // The piece `move` moves
+    Move killers[2] = {Move::none(), Move::none()};
+};
+static_assert(sizeof(SearchStack) == 16, "four frames to a cache line");
+
+class Searcher {
+public:
+    explicit Searcher(Evaluator& evaluator, OpeningBook* book = nullptr);
+    // A book move for `board`, or none; the caller checks SearchParams::use_book
+    Move probe_book(const Board& board) const;
+    SearchResult search(const Board& board, const SearchParams& params);
+    // Forgets everything learned in earlier searches: histories and
+    // counter-moves (the TT is shared and cleared on its own)
+    void clear();
+    // Searches return early once `stop` is raised, and raise it themselves
+    // when their time is up. While `ponder` is set the clock does not run.
+    // ThreadPool owns both; a lone Searcher uses a flag of its own.
+    void set_stop_flag(std::atomic<bool>* stop) { m_stop = stop; }
+    void set_ponder_flag(const std::atomic<bool>* ponder) { m_ponder = ponder; }
+
+private:
+    bool m_running = false;  // Add this line
+    OpeningBook* m_book;  // Non-owning pointer
+    enum NodeType { ROOT, PV, NON_PV };
+    template <NodeType NT>
+    int search(Board& board, int depth, int alpha, int beta);
+    int quiescence(Board& board, int alpha, int beta);
+    void update_quiet_stats(Move move, int depth, const Move* quiets_tried, int quiet_count);
+    void update_capture_stats(Move move, int depth, const Move* captures_tried, int capture_count);
+    void update_continuation(Piece piece, Square to, int bonus);
+    SearchStack* stack(int ply) {
+        assert(ply >= -STACK_LOOKBACK && ply <= MAX_PLY);
+        return &m_stack[ply + STACK_LOOKBACK];
+    }
+    // Fills in this ply's frame for `move`, before it is made
+    void push_move(const Board& board, Move move);
+    // Since the search started, for reporting, and since our clock started,
+    // for the time budget: the same but after a ponderhit
+    int64_t elapsed_ms() const;
+    int64_t clock_elapsed_ms() const;
+    bool time_elapsed() const;
+    void check_time();
+    // Every STOP_CHECK_NODES nodes, so a stop or an expired clock ends the
+    // search within a few thousand nodes wherever it is in the tree
+    bool poll_stop() {
+        if (m_nodes % STOP_CHECK_NODES == 0) check_time();
+        if (m_params.nodes && m_nodes >= m_params.nodes) m_stop->store(true, std::memory_order_relaxed);
+        return stopped();
+    }
+    bool stopped() const { return m_stop->load(std::memory_order_relaxed); }
+    std::atomic<bool> m_own_stop{false};
+    std::atomic<bool>* m_stop = &m_own_stop;
+    const std::atomic<bool>* m_ponder = nullptr;
+    bool m_pondering = false;
+    Evaluator& m_evaluator;
+    Board m_board;              // Per-thread search board, made/unmade in place
+    SearchParams m_params;
+    TimeManager m_time;
+    std::chrono::time_point<std::chrono::steady_clock> m_start_time;
+    std::chrono::time_point<std::chrono::steady_clock> m_clock_start;
+    uint64_t m_nodes = 0;
+    uint64_t m_cutoffs = 0;
+    uint64_t m_first_move_cutoffs = 0;
+    // Part of the Searcher, so each thread has its own from the start and a
+    // search never allocates one
+    alignas(64) SearchStack m_stack[STACK_SIZE];
+    ButterflyHistory m_history;      // [color][from_to]
+    CaptureHistory m_capture_history;
+    // [piece][to] of the previous move, each a PieceToHistory; 1.2 MB, so
+    // on the heap
+    std::unique_ptr<PieceToHistory[]> m_continuation_history;
+    Move m_counter_moves[NUM_PIECE_INDICES][64];  // [piece][to] of the opponent's last move
+    int m_ply = 0; // Track current ply
+    Move m_root_best = Move::none();  // In and out of search<ROOT>
+
+    // Triangular PV table: m_pv[ply] holds the best line from `ply`, in
+    // m_pv[ply][ply .. m_pv_length[ply]), built up from the child's line
+    void update_pv(Move move);
+    Move m_pv[MAX_PLY][MAX_PLY];
+    int m_pv_length[MAX_PLY + 1];
+};
+
 } // namespace ViperChess
\ No newline at end of file
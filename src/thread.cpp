@@ -0,0 +1,210 @@
+// thread.cpp
+#include "thread.hpp"
+#include <algorithm>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ViperChess {
+
+namespace {
+
+// Binds the calling thread to the index-th CPU this process may run on
+void pin_to_cpu(size_t index) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    int count = CPU_COUNT(&allowed);
+    if (count == 0) return;
+
+    int target = int(index % count);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            return;
+        }
+    }
+#elif defined(_WIN32)
+    unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (index % cpus % (8 * sizeof(DWORD_PTR))));
+#else
+    (void)index;
+#endif
+}
+
+} // namespace
+
+// ===== SearchThread =====
+SearchThread::SearchThread(ThreadPool& pool, size_t index, Evaluator& evaluator, OpeningBook* book, bool pin)
+    : m_pool(pool),
+      m_index(index),
+      m_pin(pin),
+      m_searcher(std::make_unique<Searcher>(evaluator, book))
+{
+    m_searcher->set_stop_flag(&pool.m_stop);
+    m_searcher->set_ponder_flag(&pool.m_ponder);
+    m_thread = std::thread(&SearchThread::idle_loop, this);
+    wait_for_search_finished();
+}
+
+SearchThread::~SearchThread() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    start_searching();
+    m_thread.join();
+}
+
+void SearchThread::start_searching() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_searching = true;
+    m_cv.notify_all();
+}
+
+void SearchThread::wait_for_search_finished() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_searching; });
+}
+
+void SearchThread::idle_loop() {
+    if (m_pin) {
+        pin_to_cpu(m_index);
+    }
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_searching = false;
+        m_cv.notify_all();  // Wakes wait_for_search_finished()
+        m_cv.wait(lock, [this] { return m_searching; });
+        if (m_exit) return;
+        lock.unlock();
+
+        if (m_index == 0) {
+            m_pool.main_search();
+        } else {
+            m_pool.helper_search(*this);
+        }
+    }
+}
+
+// ===== ThreadPool =====
+ThreadPool::ThreadPool(Evaluator& evaluator, OpeningBook* book)
+    : m_evaluator(evaluator), m_book(book)
+{
+    set(1);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+    wait_for_search_finished();
+    m_threads.clear();
+}
+
+void ThreadPool::set(size_t count) {
+    wait_for_search_finished();
+    m_threads.clear();
+
+    // A lone thread is left to the OS scheduler, which may be running other
+    // engines on the same machine. Only the main thread consults the book.
+    count = std::max<size_t>(1, count);
+    for (size_t i = 0; i < count; ++i) {
+        m_threads.push_back(std::make_unique<SearchThread>(*this, i, m_evaluator,
+                                                           i == 0 ? m_book : nullptr, count > 1));
+    }
+}
+
+void ThreadPool::start_search(const Board& board, const SearchParams& params,
+                              std::function<void(const SearchResult&)> on_done) {
+    wait_for_search_finished();
+
+    m_root = board;
+    m_params = params;
+    m_on_done = std::move(on_done);
+    m_stop.store(false, std::memory_order_relaxed);
+    m_ponder.store(params.ponder, std::memory_order_relaxed);
+    TT.new_search();
+
+    // The main thread wakes the helpers itself
+    m_threads.front()->start_searching();
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_signal_mutex);
+        m_stop.store(true, std::memory_order_relaxed);
+    }
+    m_signal_cv.notify_all();
+}
+
+void ThreadPool::ponderhit() {
+    {
+        std::lock_guard<std::mutex> lock(m_signal_mutex);
+        m_ponder.store(false, std::memory_order_relaxed);
+    }
+    m_signal_cv.notify_all();
+}
+
+void ThreadPool::wait_for_search_finished() {
+    if (!m_threads.empty()) {
+        m_threads.front()->wait_for_search_finished();
+    }
+}
+
+void ThreadPool::clear() {
+    wait_for_search_finished();
+    for (auto& thread : m_threads) {
+        thread->m_searcher->clear();
+    }
+}
+
+void ThreadPool::main_search() {
+    for (size_t i = 1; i < m_threads.size(); ++i) {
+        m_threads[i]->start_searching();
+    }
+
+    SearchResult result = m_threads.front()->m_searcher->search(m_root, m_params);
+
+    if (m_params.infinite || m_params.ponder) {
+        std::unique_lock<std::mutex> lock(m_signal_mutex);
+        m_signal_cv.wait(lock, [this] {
+            return m_stop.load(std::memory_order_relaxed)
+                || (!m_params.infinite && !m_ponder.load(std::memory_order_relaxed));
+        });
+    }
+
+    // This thread decides the move; the helpers are only there to help it
+    stop();
+    for (size_t i = 1; i < m_threads.size(); ++i) {
+        m_threads[i]->wait_for_search_finished();
+        result.nodes += m_threads[i]->result().nodes;
+    }
+
+    m_threads.front()->m_result = result;
+    if (m_on_done) m_on_done(result);
+}
+
+void ThreadPool::helper_search(SearchThread& thread) {
+    // Every other helper searches one ply deeper, so the threads reach
+    // different parts of the tree first and fill the shared table for
+    // each other
+    // The main thread alone watches the clock and the node budget, stops the
+    // others and reports
+    SearchParams params = m_params;
+    params.depth += thread.m_index % 2;
+    params.use_time = false;
+    params.ponder = false;
+    params.nodes = 0;
+    params.on_iteration = nullptr;
+    thread.m_result = thread.m_searcher->search(m_root, params);
+}
+
+} // namespace ViperChess
@@ -0,0 +1,102 @@
+// thread.hpp
+#pragma once
+#include "search.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ViperChess {
+
+class ThreadPool;
+
+// One search thread of the pool. It owns its Searcher, so history and killer
+// tables live as long as the thread does, and it sleeps on a condition
+// variable between searches instead of being created for each one.
+class SearchThread {
+public:
+    SearchThread(ThreadPool& pool, size_t index, Evaluator& evaluator, OpeningBook* book, bool pin);
+    ~SearchThread();
+
+    SearchThread(const SearchThread&) = delete;
+    SearchThread& operator=(const SearchThread&) = delete;
+
+    void start_searching();
+    void wait_for_search_finished();
+
+    const SearchResult& result() const { return m_result; }
+
+private:
+    friend class ThreadPool;
+    void idle_loop();
+
+    ThreadPool& m_pool;
+    const size_t m_index;  // 0 is the main thread, which decides the move
+    const bool m_pin;      // Bind to a CPU of its own
+    std::unique_ptr<Searcher> m_searcher;
+    SearchResult m_result;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_searching = true;  // Until the thread reaches idle_loop
+    bool m_exit = false;
+    std::thread m_thread;
+};
+
+// Lazy SMP over a persistent set of threads. Every thread searches the same
+// root, sharing only the transposition table; helpers alternate between the
+// requested depth and one ply deeper. With more than one thread, each is
+// pinned to its own CPU.
+class ThreadPool {
+public:
+    ThreadPool(Evaluator& evaluator, OpeningBook* book = nullptr);
+    ~ThreadPool();
+
+    // Waits for any running search, then replaces the threads
+    void set(size_t count);
+    size_t size() const { return m_threads.size(); }
+
+    // Starts a search and returns at once. When the main thread is done it
+    // stops the helpers, adds their nodes to its result and hands that to
+    // `on_done`, still on the main search thread.
+    void start_search(const Board& board, const SearchParams& params,
+                      std::function<void(const SearchResult&)> on_done = {});
+    // Safe to call from any thread at any time. The main thread notices
+    // within STOP_CHECK_NODES nodes and reports its best move so far.
+    void stop();
+    // The expected move was played: a `go ponder` search becomes a normal
+    // one, with its clock starting now
+    void ponderhit();
+    void wait_for_search_finished();
+    // Waits for any running search, then clears every thread's histories
+    void clear();
+
+    // Result of the last finished search
+    const SearchResult& result() const { return m_threads.front()->result(); }
+
+private:
+    friend class SearchThread;
+    void main_search();
+    void helper_search(SearchThread& thread);
+
+    Evaluator& m_evaluator;
+    OpeningBook* m_book;
+    std::vector<std::unique_ptr<SearchThread>> m_threads;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_ponder{false};
+
+    // UCI forbids answering `go infinite` or `go ponder` before `stop` or
+    // `ponderhit`, so a search that ends early waits here for either
+    std::mutex m_signal_mutex;
+    std::condition_variable m_signal_cv;
+
+    // Copied at start_search so the caller may change its board meanwhile
+    Board m_root;
+    SearchParams m_params;
+    std::function<void(const SearchResult&)> m_on_done;
+};
+
+} // namespace ViperChess
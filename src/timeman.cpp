@@ -0,0 +1,62 @@
+// timeman.cpp
+#include "timeman.hpp"
+#include "search.hpp"
+#include <algorithm>
+
+namespace ViperChess {
+
+namespace {
+
+// Moves the clock has to last when the GUI does not say, and the most it is
+// planned for when it does
+constexpr int MOVE_HORIZON = 40;
+
+// The maximum is this many optimums, but never more than a share of the
+// clock: nearly all of it before the last move of a time control, half of
+// it otherwise
+constexpr int MAXIMUM_RATIO = 5;
+constexpr double LAST_MOVE_SHARE = 0.9;
+constexpr double MAXIMUM_SHARE = 0.5;
+
+// No new iteration starts past this share of the scaled optimum
+constexpr double NEXT_ITERATION_SHARE = 0.5;
+
+} // namespace
+
+void TimeManager::init(const SearchParams& params, Color us) {
+    m_clock = !params.infinite && params.time_left[us] >= 0;
+    if (!m_clock) {
+        m_optimum = m_maximum = params.time_ms;
+        return;
+    }
+
+    // The clock has to last `moves_to_go` moves. Each of them loses the
+    // overhead on top of its search time, and all but this one bring the
+    // increment; two more overheads are kept back as a reserve.
+    const int moves_to_go = params.moves_to_go > 0 ? std::min(params.moves_to_go, MOVE_HORIZON) : MOVE_HORIZON;
+    const int64_t time_left = params.time_left[us];
+    const int64_t budget = time_left + int64_t(params.increment[us]) * (moves_to_go - 1)
+                         - int64_t(params.move_overhead) * (moves_to_go + 2);
+    const int64_t optimum = std::max<int64_t>(1, budget / moves_to_go);
+
+    // The maximum is a share of what is actually on the clock now
+    const int64_t available = std::max<int64_t>(1, time_left - params.move_overhead);
+    const double share = moves_to_go == 1 ? LAST_MOVE_SHARE : MAXIMUM_SHARE;
+    m_maximum = std::max<int64_t>(1, std::min<int64_t>(optimum * MAXIMUM_RATIO, int64_t(available * share)));
+    m_optimum = std::min(optimum, m_maximum);
+}
+
+bool TimeManager::stop_iterating(int64_t elapsed, int stable_iterations, int score_drop) const {
+    if (!m_clock) return false;
+
+    // A best move that just changed gets 30% more than the optimum, one that
+    // has held for seven iterations 40% less; a score that fell by 100 cp
+    // half as much again, up to twice as much
+    const double stability = std::max(0.6, 1.3 - 0.1 * stable_iterations);
+    const double falling = std::clamp(1.0 + score_drop / 200.0, 1.0, 2.0);
+    // The next iteration takes about as long as all before it together, so
+    // one that starts past half the target would end well past it
+    return elapsed >= m_optimum * stability * falling * NEXT_ITERATION_SHARE;
+}
+
+} // namespace ViperChess
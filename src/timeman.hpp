@@ -0,0 +1,32 @@
+// timeman.hpp
+#pragma once
+#include "board.hpp"
+
+namespace ViperChess {
+
+struct SearchParams;
+
+// Time budget of one search. On a clock the optimum is what this move
+// should take and the maximum what it may take at worst; the search stops
+// at the maximum wherever it is, and does not start another iteration past
+// the optimum as scaled by stop_iterating(). `go movetime` sets both to the
+// fixed time, and then only the maximum applies.
+class TimeManager {
+public:
+    void init(const SearchParams& params, Color us);
+
+    int64_t optimum() const { return m_optimum; }
+    int64_t maximum() const { return m_maximum; }
+
+    // After a completed iteration: whether the next one should not start.
+    // `stable_iterations` counts the iterations in a row that kept the best
+    // move; `score_drop` is how far the score fell in the last one.
+    bool stop_iterating(int64_t elapsed, int stable_iterations, int score_drop) const;
+
+private:
+    bool m_clock = false;
+    int64_t m_optimum = 0;
+    int64_t m_maximum = 0;
+};
+
+} // namespace ViperChess
@@ -0,0 +1,174 @@
+// tt.cpp
+#include "tt.hpp"
+#include "search.hpp"  // INF
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace ViperChess {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// `size` is a multiple of HUGE_PAGE_SIZE. Falls back to cache-line
+// alignment when the huge-page-aligned allocation fails; madvise failing
+// (no transparent huge page support) just leaves normal pages.
+void* alloc_large(size_t size) {
+#if defined(_WIN32)
+    // Large pages on Windows need a privilege most users lack; normal pages
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* mem = std::aligned_alloc(HUGE_PAGE_SIZE, size);
+#if defined(MADV_HUGEPAGE)
+    if (mem) madvise(mem, size, MADV_HUGEPAGE);
+#endif
+    return mem ? mem : std::aligned_alloc(64, size);
+#endif
+}
+
+void free_large(void* mem) {
+#if defined(_WIN32)
+    if (mem) VirtualFree(mem, 0, MEM_RELEASE);
+#else
+    std::free(mem);
+#endif
+}
+
+} // namespace
+
+TranspositionTable TT(16);
+
+TranspositionTable::TranspositionTable(size_t mb_size) {
+    resize(mb_size);
+}
+
+TranspositionTable::~TranspositionTable() {
+    free_large(m_buckets);
+}
+
+void TranspositionTable::resize(size_t mb_size) {
+    free_large(m_buckets);  // Free the old table before allocating the new one
+    m_buckets = nullptr;
+
+    m_bucket_count = std::max<size_t>(1, mb_size * 1024 * 1024 / sizeof(Bucket));
+    m_alloc_size = (m_bucket_count * sizeof(Bucket) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    m_buckets = static_cast<Bucket*>(alloc_large(m_alloc_size));
+    if (!m_buckets) throw std::bad_alloc();
+
+    clear();
+}
+
+void TranspositionTable::clear() {
+    // One thread per 16 MB, at most one per core
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t threads = std::clamp<size_t>(m_alloc_size >> 24, 1, cores);
+
+    auto zero = [this, threads](size_t index) {
+        size_t begin = m_bucket_count * index / threads;
+        size_t end = m_bucket_count * (index + 1) / threads;
+        for (size_t i = begin; i < end; ++i) {
+            new (&m_buckets[i]) Bucket();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(zero, i);
+    }
+    zero(0);
+    for (auto& t : workers) {
+        t.join();
+    }
+    m_generation = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& out) const {
+    for (const Entry& e : bucket_for(key).entries) {
+        uint64_t data = e.data.load(std::memory_order_relaxed);
+        if ((e.check.load(std::memory_order_relaxed) ^ data) != key) continue;
+
+        out.move = Move(uint16_t(data));
+        out.score = int16_t(data >> 16);
+        out.eval = int16_t(data >> 32);
+        out.depth = depth_of(data);
+        out.flag = data >> 56 & 3;
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, int eval, Move move, uint8_t flag) {
+    // The INF sentinels are not scores and are not kept; every real score
+    // fits the packed 16-bit field
+    if (std::abs(score) >= INF) return;
+    assert(score >= std::numeric_limits<int16_t>::min() && score <= std::numeric_limits<int16_t>::max());
+    eval = std::clamp(eval, EVAL_NONE, int(std::numeric_limits<int16_t>::max()));
+    depth = std::clamp(depth, 0, 255);
+
+    Bucket& bucket = bucket_for(key);
+    Entry* replace = nullptr;
+
+    // The same position is overwritten in place, unless it holds a clearly
+    // deeper non-exact result of this search
+    for (Entry& e : bucket.entries) {
+        uint64_t old = e.data.load(std::memory_order_relaxed);
+        if ((e.check.load(std::memory_order_relaxed) ^ old) != key) continue;
+
+        if (flag != EXACT && depth + 4 < depth_of(old) && generation_of(old) == m_generation) {
+            return;
+        }
+        if (!move.is_valid()) move = Move(uint16_t(old));  // Keep the old best move
+        replace = &e;
+        break;
+    }
+
+    // Otherwise evict the entry that is shallowest once age is counted:
+    // every search since it was written costs it 8 plies
+    if (!replace) {
+        int worst = std::numeric_limits<int>::max();
+        for (Entry& e : bucket.entries) {
+            uint64_t old = e.data.load(std::memory_order_relaxed);
+            int age = (m_generation - generation_of(old)) & GENERATION_MASK;
+            int value = depth_of(old) - 8 * age;
+            if (value < worst) {
+                worst = value;
+                replace = &e;
+            }
+        }
+    }
+
+    uint64_t data = uint64_t(move.raw())
+                  | uint64_t(uint16_t(int16_t(score))) << 16
+                  | uint64_t(uint16_t(int16_t(eval))) << 32
+                  | uint64_t(depth) << 48
+                  | uint64_t(flag) << 56
+                  | uint64_t(m_generation) << 58;
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    const size_t buckets = std::min<size_t>(m_bucket_count, 1000 / BUCKET_SIZE);
+    int used = 0;
+    for (size_t i = 0; i < buckets; ++i) {
+        for (const Entry& e : m_buckets[i].entries) {
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            used += data != 0 && generation_of(data) == m_generation;
+        }
+    }
+    return int(used * 1000 / (buckets * BUCKET_SIZE));
+}
+
+} // namespace ViperChess
@@ -0,0 +1,95 @@
+// tt.hpp
+#pragma once
+#include "board.hpp"
+#include <atomic>
+
+namespace ViperChess {
+
+enum TTFlag {
+    EXACT,
+    LOWER_BOUND,
+    UPPER_BOUND
+};
+
+// Static eval field of an entry stored without one
+constexpr int EVAL_NONE = -32768;
+
+// What a probe hit returns, unpacked
+struct TTData {
+    Move move;
+    int score;
+    int eval;
+    int depth;
+    uint8_t flag;
+};
+
+// Transposition table shared by every search thread. It is an array of
+// 64-byte buckets, one cache line each, holding four entries. Threads read
+// and write it concurrently without locks: an entry's payload is packed into
+// one 64-bit word stored next to (key ^ payload), so a slot torn by two
+// racing writers fails verification on probe and reads as a miss.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t mb_size);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Reallocates and clears the table; no search may be running. The
+    // memory is 2 MB aligned and marked for transparent huge pages, so a
+    // multi-gigabyte table does not miss the TLB on every probe.
+    void resize(size_t mb_size);
+
+    // Zeroes the table, split over threads for large sizes. This is also
+    // the first touch of freshly allocated memory.
+    void clear();
+
+    // Pulls the bucket of `key` towards the cache; make_move calls it as
+    // soon as the child key is known, ahead of the child's probe
+    void prefetch(uint64_t key) const { __builtin_prefetch(&bucket_for(key)); }
+
+    // Called once per `go`: entries from earlier searches age and get
+    // replaced before deeper entries of the current one
+    void new_search() { m_generation = (m_generation + 1) & GENERATION_MASK; }
+
+    bool probe(uint64_t key, TTData& data) const;
+    void store(uint64_t key, int depth, int score, int eval, Move move, uint8_t flag);
+
+    // Permille of sampled entries written by the current search, for UCI
+    int hashfull() const;
+
+private:
+    // Payload layout: move 0-15, score 16-31, eval 32-47 (both signed),
+    // depth 48-55, flag 56-57, generation 58-63
+    static constexpr int GENERATION_MASK = 63;
+    static int depth_of(uint64_t data) { return int(data >> 48 & 0xFF); }
+    static int generation_of(uint64_t data) { return int(data >> 58); }
+
+    struct Entry {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;
+    };
+
+    static constexpr int BUCKET_SIZE = 4;
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_SIZE];
+    };
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    // Maps the key onto [0, bucket count) with a multiply-high, so the count
+    // need not be a power of two
+    Bucket& bucket_for(uint64_t key) const {
+        return m_buckets[size_t((unsigned __int128)key * m_bucket_count >> 64)];
+    }
+
+    Bucket* m_buckets = nullptr;
+    size_t m_bucket_count = 0;
+    size_t m_alloc_size = 0;
+    uint8_t m_generation = 0;
+};
+
+// The one table all searchers share
+extern TranspositionTable TT;
+
+} // namespace ViperChess
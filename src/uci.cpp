@@ -1,160 +1,295 @@
-#include "uci.hpp"
-#include <sstream>
-#include <thread>
-#include <iostream>
-
-namespace ViperChess {
-
-UCI::UCI(Board& board, Evaluator& evaluator) 
-    : m_board(board),
-      m_evaluator(evaluator),  // Store evaluator reference
-      m_searcher(m_evaluator, &m_book)  // Initialize searcher
-{
-    // Load default book
-    m_book.load("books/book.bin");
-}
-
-void UCI::loop() {
-    // Load default book
-    
-    std::string line;
-    while (std::getline(std::cin, line)) {
-        std::istringstream iss(line);
-        std::string command;
-        iss >> command;
-
-        if (command == "uci") {
-            handle_uci();
-        } else if (command == "isready") {
-            handle_isready();
-        } else if (command == "position") {
-            std::string args;
-            std::getline(iss, args);
-            handle_position(args);
-        } else if (command == "go") {
-            std::string args;
-            std::getline(iss, args);
-            handle_go(args);
-        } else if (command == "stop") {
-            handle_stop();
-        } else if (command == "setoption") {
-            handle_setoption(iss);
-        } else if (command == "quit") {
-            break;
-        }
-    }
-}
-
-void UCI::handle_setoption(std::istringstream& iss) {
-    std::string token;
-    iss >> token; // Read "name"
-    iss >> token; // Read option name
-    
-    if (token == "OwnBook") {
-        iss >> token; // skip "value"
-        iss >> m_use_book;
-        std::cout << "info string Book usage " << (m_use_book ? "enabled" : "disabled") << "\n";
-    } else if (token == "BookFile") {
-        iss >> token; // skip "value"
-        std::string book_file;
-        iss >> book_file;
-        if (m_book.load(book_file)) {
-            std::cout << "info string Loaded book: " << book_file << "\n";
-        } else {
-            std::cout << "info string Failed to load book: " << book_file << "\n";
-        }
-    }
-}
-
-void UCI::handle_uci() {
-    std::cout << "id name ViperChessMegaEdition\n";
-    std::cout << "id author dtdhow (AUTHORS FILE)\n";
-    std::cout << "option name OwnBook type check default true\n";
-    std::cout << "option name BookFile type string default book.bin\n";
-    std::cout << "uciok\n";
-}
-
-void UCI::handle_isready() {
-    std::cout << "readyok\n";
-}
-
-void UCI::handle_position(const std::string& args) {
-    std::istringstream iss(args);
-    std::string token;
-    
-    // Parse position
-    iss >> token;
-    if (token == "startpos") {
-        m_board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-        iss >> token; // Consume "moves" if present
-    } else if (token == "fen") {
-        std::string fen;
-        while (iss >> token && token != "moves") {
-            fen += token + " ";
-        }
-        m_board.set_fen(fen);
-    }
-
-    // Parse moves
-    if (token == "moves") {
-        while (iss >> token) {
-            Move move = {
-                static_cast<Square>(token[0] - 'a' + (token[1] - '1') * 8),
-                static_cast<Square>(token[2] - 'a' + (token[3] - '1') * 8),
-                token.length() > 4 ? char_to_piece(token[4]) : NONE_PIECE
-            };
-            m_board.make_move(move);
-        }
-    }
-    
-    if (m_use_book && m_book.is_loaded() && m_board.get_fullmove_number() < 10) {
-        Move book_move = m_book.probe(m_board);
-        if (book_move.is_valid()) {
-            m_board.make_move(book_move);
-        }
-    }
-}
-
-void UCI::handle_go(const std::string& args) {
-    SearchParams params;
-    std::istringstream iss(args);
-    std::string token;
-    
-    while (iss >> token) {
-        if (token == "depth") {
-            iss >> params.depth;
-        } else if (token == "movetime") {
-            iss >> params.time_ms;
-        } else if (token == "infinite") {
-            params.infinite = true;
-        }
-    }
-
-    m_running = true;
-    std::thread search_thread([this, params]() {
-        SearchResult result = m_searcher.search(m_board, params);
-        if (m_running) {
-            print_best_move(result.best_move);
-        }
-    });
-    search_thread.detach();
-}
-
-void UCI::handle_stop() {
-    m_running = false;
-    // Note: Actual stopping requires search changes (not shown here for brevity)
-}
-
-void UCI::print_best_move(const Move& move) {
-    std::cout << "bestmove ";
-    std::cout << char('a' + m_board.file_of(move.from));
-    std::cout << char('1' + m_board.rank_of(move.from));
-    std::cout << char('a' + m_board.file_of(move.to));
-    std::cout << char('1' + m_board.rank_of(move.to));
-    if (move.promotion != NONE_PIECE) {
-        std::cout << char(tolower(" PNBRQK"[move.promotion]));
-    }
-    std::cout << "\n";
-}
-
+#include "uci.hpp"
+#include "perft.hpp"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <iostream>
+
+namespace ViperChess {
+
+namespace {
+
+// "cp 35", or "mate 3" / "mate -2" in moves (not plies) for mate scores
+std::string score_to_uci(int score) {
+    if (score >= MATE_IN_MAX_PLY) return "mate " + std::to_string((MATE - score + 1) / 2);
+    if (score <= -MATE_IN_MAX_PLY) return "mate " + std::to_string(-(MATE + score) / 2);
+    return "cp " + std::to_string(score);
+}
+
+// One `info` line for a finished iteration or search, newline included
+std::string info_line(const SearchResult& result) {
+    std::ostringstream out;
+    out << "info depth " << result.depth
+        << " score " << score_to_uci(result.score)
+        << " nodes " << result.nodes
+        << " nps " << result.nodes * 1000 / std::max<int64_t>(1, result.time_ms)
+        << " time " << result.time_ms
+        << " hashfull " << TT.hashfull()
+        << " pv";
+    for (const Move& move : result.pv) {
+        out << " " << move_to_uci(move);
+    }
+    out << "\n";
+    return out.str();
+}
+
+} // namespace
+
+UCI::UCI(Board& board, Evaluator& evaluator) 
+    : m_board(board),
+      m_evaluator(evaluator),  // Store evaluator reference
+      m_threads(m_evaluator, &m_book)  // Search threads, started once
+{
+    // Load default book
+    m_book.load("books/book.bin");
+}
+
+void UCI::loop() {
+    // Load default book
+    
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream iss(line);
+        std::string command;
+        iss >> command;
+
+        if (command == "uci") {
+            handle_uci();
+        } else if (command == "isready") {
+            handle_isready();
+        } else if (command == "ucinewgame") {
+            m_threads.clear();
+            TT.clear();
+        } else if (command == "position") {
+            std::string args;
+            std::getline(iss, args);
+            handle_position(args);
+        } else if (command == "go") {
+            std::string args;
+            std::getline(iss, args);
+            handle_go(args);
+        } else if (command == "stop") {
+            handle_stop();
+        } else if (command == "ponderhit") {
+            m_threads.ponderhit();
+        } else if (command == "perft" || command == "divide") {
+            // Non-standard: count the legal move tree of the current position
+            std::string args;
+            std::getline(iss, args);
+            handle_perft(args, command == "divide");
+        } else if (command == "setoption") {
+            handle_setoption(iss);
+        } else if (command == "quit") {
+            break;
+        }
+    }
+}
+
+void UCI::handle_setoption(std::istringstream& iss) {
+    // setoption name <id> [value <x>], where the id may contain spaces
+    std::string token;
+    std::string name;
+    iss >> token; // Read "name"
+    while (iss >> token && token != "value") {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    
+    if (name == "OwnBook") {
+        iss >> token;
+        m_use_book = token == "true";
+        std::cout << "info string Book usage " << (m_use_book ? "enabled" : "disabled") << "\n";
+    } else if (name == "BookFile") {
+        std::string book_file;
+        iss >> book_file;
+        if (m_book.load(book_file)) {
+            std::cout << "info string Loaded book: " << book_file << "\n";
+        } else {
+            std::cout << "info string Failed to load book: " << book_file << "\n";
+        }
+    } else if (name == "Hash") {
+        int mb = 16;
+        iss >> mb;
+        mb = std::clamp(mb, 1, 65536);
+        m_threads.wait_for_search_finished();
+        TT.resize(mb);
+        std::cout << "info string Hash " << mb << " MB\n";
+    } else if (name == "Threads") {
+        int threads = 1;
+        iss >> threads;
+        threads = std::clamp(threads, 1, 512);
+        m_threads.set(threads);
+        std::cout << "info string Threads " << threads << "\n";
+    } else if (name == "Move Overhead") {
+        iss >> m_move_overhead;
+        m_move_overhead = std::clamp(m_move_overhead, 0, 5000);
+        std::cout << "info string Move Overhead " << m_move_overhead << " ms\n";
+    } else if (name == "LMR" || name == "Futility" || name == "SEEPruning") {
+        iss >> token;
+        (name == "LMR" ? m_lmr : name == "Futility" ? m_futility : m_see_pruning) = token == "true";
+        std::cout << "info string " << name << " " << (token == "true" ? "enabled" : "disabled") << "\n";
+    }
+}
+
+void UCI::handle_uci() {
+    std::cout << "id name ViperChessMegaEdition\n";
+    std::cout << "id author dtdhow (AUTHORS FILE)\n";
+    std::cout << "option name OwnBook type check default true\n";
+    std::cout << "option name BookFile type string default book.bin\n";
+    std::cout << "option name Hash type spin default 16 min 1 max 65536\n";
+    std::cout << "option name Threads type spin default 1 min 1 max 512\n";
+    std::cout << "option name Move Overhead type spin default 10 min 0 max 5000\n";
+    std::cout << "option name LMR type check default true\n";
+    std::cout << "option name Futility type check default true\n";
+    std::cout << "option name SEEPruning type check default true\n";
+    std::cout << "uciok\n";
+}
+
+void UCI::handle_isready() {
+    std::cout << "readyok\n";
+}
+
+void UCI::handle_position(const std::string& args) {
+    std::istringstream iss(args);
+    std::string token;
+    
+    // Parse position
+    iss >> token;
+    if (token == "startpos") {
+        m_board.set_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        iss >> token; // Consume "moves" if present
+    } else if (token == "fen") {
+        std::string fen;
+        while (iss >> token && token != "moves") {
+            fen += token + " ";
+        }
+        m_board.set_fen(fen);
+    }
+
+    // Parse moves
+    if (token == "moves") {
+        while (iss >> token) {
+            Move move = parse_move(token);
+            if (!move.is_valid()) break;
+            m_board.make_move(move);
+        }
+    }
+}
+
+void UCI::handle_go(const std::string& args) {
+    SearchParams params;
+    std::istringstream iss(args);
+    std::string token;
+    bool depth_given = false;
+    bool time_given = false;
+    params.move_overhead = m_move_overhead;
+    params.lmr = m_lmr;
+    params.futility = m_futility;
+    params.see_pruning = m_see_pruning;
+    params.use_book = m_use_book;
+    
+    while (iss >> token) {
+        if (token == "depth") {
+            iss >> params.depth;
+            depth_given = true;
+        } else if (token == "movetime") {
+            iss >> params.time_ms;
+            time_given = true;
+        } else if (token == "wtime") {
+            iss >> params.time_left[WHITE];
+        } else if (token == "btime") {
+            iss >> params.time_left[BLACK];
+        } else if (token == "winc") {
+            iss >> params.increment[WHITE];
+        } else if (token == "binc") {
+            iss >> params.increment[BLACK];
+        } else if (token == "movestogo") {
+            iss >> params.moves_to_go;
+        } else if (token == "nodes") {
+            iss >> params.nodes;
+        } else if (token == "infinite") {
+            params.infinite = true;
+        } else if (token == "ponder") {
+            params.ponder = true;
+        }
+    }
+
+    // A fixed move time overrides the clock
+    const bool clock_given = params.time_left[m_board.get_side_to_move()] >= 0;
+    if (time_given) {
+        params.time_left[WHITE] = params.time_left[BLACK] = -1;
+    }
+
+    // A node budget alone is not also cut by the default move time, so the
+    // search is the same however loaded the machine is
+    if (params.nodes && !time_given && !clock_given) {
+        params.use_time = false;
+    }
+
+    // Searches bounded by the clock, the node budget or by `stop` are not
+    // also cut at the default depth
+    if (!depth_given && (time_given || clock_given || params.nodes || params.infinite || params.ponder)) {
+        params.depth = MAX_DEPTH;
+    }
+
+    // Both run on the main search thread. The GUI may be waiting on these
+    // lines while our input thread sits in getline, so flush them right away.
+    m_reported_nodes = 0;
+    params.on_iteration = [this](const SearchResult& result) {
+        m_reported_nodes = result.nodes;
+        std::cout << info_line(result) << std::flush;
+    };
+
+    // A final info line only when it adds something: the helpers' nodes, or
+    // the work of an unfinished iteration
+    m_threads.start_search(m_board, params, [this](const SearchResult& result) {
+        std::string out;
+        if (result.nodes != m_reported_nodes) out = info_line(result);
+        // UCI's null move, for mate or stalemate at the root
+        out += "bestmove " + (result.best_move.is_valid() ? move_to_uci(result.best_move) : "0000");
+        if (result.pv.size() > 1) {
+            out += " ponder " + move_to_uci(result.pv[1]);
+        }
+        std::cout << out << "\n" << std::flush;
+    });
+}
+
+void UCI::handle_perft(const std::string& args, bool divide) {
+    std::istringstream iss(args);
+    int depth = 1;
+    iss >> depth;
+
+    PerftHash hash(16);
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    print_perft(std::cout, perft(m_board, depth, threads, &hash), divide);
+}
+
+void UCI::handle_stop() {
+    // The search thread prints bestmove once it has unwound
+    m_threads.stop();
+}
+
+Move UCI::parse_move(const std::string& token) const {
+    if (token.length() < 4) return Move::none();
+
+    // The text carries no castling or en passant marker, so take the flags
+    // from the generated move
+    Move move(static_cast<Square>(token[0] - 'a' + (token[1] - '1') * 8),
+              static_cast<Square>(token[2] - 'a' + (token[3] - '1') * 8),
+              token.length() > 4 ? char_to_piece(token[4]) : NONE_PIECE);
+
+    MoveList legal_moves;
+    m_board.generate_legal_moves(legal_moves);
+    for (const Move& legal_move : legal_moves) {
+        if (legal_move.from() == move.from() && legal_move.to() == move.to() &&
+            legal_move.promotion() == move.promotion()) {
+            return legal_move;
+        }
+    }
+    return Move::none();
+}
+
+void UCI::print_best_move(const Move& move) {
+    std::cout << "bestmove " << move_to_uci(move) << "\n";
+}
+
 } // namespace ViperChess
\ No newline at end of file
@@ -1,31 +1,40 @@
-#pragma once
-#include "board.hpp"
-#include "search.hpp"
-#include "book.hpp"
-#include <string>
-
-namespace ViperChess {
-
-class UCI {
-public:
-    UCI(Board& board, Evaluator& evaluator);  // Constructor declaration
-    
-    void loop();
-    void handle_uci();
-    void handle_isready();
-    void handle_position(const std::string& args);
-    void handle_go(const std::string& args);
-    void handle_stop();
-    void handle_setoption(std::istringstream& iss);
-    void print_best_move(const Move& move);
-private:
-    Board& m_board;
-    Evaluator& m_evaluator;  // Change to reference
-    Searcher m_searcher;
-    OpeningBook m_book;
-
-    bool m_use_book = true;
-    bool m_running = false;
-};
-
+#pragma once
+#include "board.hpp"
+#include "search.hpp"
+#include "thread.hpp"
+#include "book.hpp"
+#include <string>
+
+namespace ViperChess {
+
+class UCI {
+public:
+    UCI(Board& board, Evaluator& evaluator);  // Constructor declaration
+    
+    void loop();
+    void handle_uci();
+    void handle_isready();
+    void handle_position(const std::string& args);
+    void handle_go(const std::string& args);
+    void handle_stop();
+    void handle_perft(const std::string& args, bool divide);
+    void handle_setoption(std::istringstream& iss);
+    void print_best_move(const Move& move);
+private:
+    // Long algebraic move text ("e2e4", "e7e8q") to the matching legal move
+    Move parse_move(const std::string& token) const;
+
+    Board& m_board;
+    Evaluator& m_evaluator;  // Change to reference
+    OpeningBook m_book;
+    ThreadPool m_threads;  // Declared after m_book, which it points to
+
+    bool m_use_book = true;
+    bool m_lmr = true;       // Search options, copied into SearchParams on go
+    bool m_futility = true;
+    bool m_see_pruning = true;
+    int m_move_overhead = 10;  // ms
+    uint64_t m_reported_nodes = 0;  // Of the last info line; search thread only
+};
+
 }
\ No newline at end of file